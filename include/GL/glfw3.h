@@ -387,15 +387,20 @@ extern "C" {
  * Other definitions
  *************************************************************************/
 
-/* glfwOpenWindow modes */
+/* glfwOpenWindow modes
+ * GLFW_OFFSCREEN contexts render to a pbuffer, but still need a connection
+ * to a window system; on X11, glfwInit fails without an X server */
 #define GLFW_WINDOWED             0x00010001
 #define GLFW_FULLSCREEN           0x00010002
+#define GLFW_OFFSCREEN            0x00010003
 
 /* glfwGetWindowParam tokens */
 #define GLFW_ACTIVE               0x00020001
 #define GLFW_ICONIFIED            0x00020002
 #define GLFW_ACCELERATED          0x00020003
 #define GLFW_OPENGL_REVISION      0x00020004
+#define GLFW_SWAP_INTERVAL        0x00020005
+#define GLFW_SWAP_CONTROL         0x00020006
 
 /* The following constants are used for both glfwGetWindowParam
  * and glfwOpenWindowHint
@@ -433,12 +438,19 @@ extern "C" {
 #define GLFW_OPENGL_COMPAT_PROFILE 0x00000002
 #define GLFW_OPENGL_ES2_PROFILE   0x00000004
 
+/* GLFW_SWAP_CONTROL bit tokens */
+#define GLFW_SWAP_INTERVAL_BIT    0x00000001 /* Positive intervals */
+#define GLFW_SWAP_IMMEDIATE_BIT   0x00000002 /* Interval zero */
+#define GLFW_SWAP_TEAR_BIT        0x00000004 /* Negative (adaptive) intervals */
+
 /* glfwGetInputMode/glfwSetInputMode tokens */
 #define GLFW_CURSOR_MODE          0x00030001
 #define GLFW_STICKY_KEYS          0x00030002
 #define GLFW_STICKY_MOUSE_BUTTONS 0x00030003
 #define GLFW_SYSTEM_KEYS          0x00030004
 #define GLFW_KEY_REPEAT           0x00030005
+#define GLFW_MOTION_COALESCING    0x00030006
+#define GLFW_INPUT_QUEUE          0x00030007
 
 /* GLFW_CURSOR_MODE values */
 #define GLFW_CURSOR_NORMAL       0x00040001
@@ -450,6 +462,14 @@ extern "C" {
 #define GLFW_AXES                 0x00050002
 #define GLFW_BUTTONS              0x00050003
 
+/* glfwSetJoystickCallback events */
+#define GLFW_CONNECTED            0x00060001
+#define GLFW_DISCONNECTED         0x00060002
+
+/* GLFWjoystickevent types */
+#define GLFW_AXIS_EVENT           0x00061001
+#define GLFW_BUTTON_EVENT         0x00061002
+
 /* glfwGetError/glfwErrorString tokens */
 #define GLFW_NO_ERROR             0
 #define GLFW_NOT_INITIALIZED      0x00070001
@@ -463,6 +483,19 @@ extern "C" {
 #define GLFW_WINDOW_NOT_ACTIVE    0x00070009
 #define GLFW_FORMAT_UNAVAILABLE   0x0007000A
 
+/* glfwGetCounter tokens */
+#define GLFW_EVENTS_PROCESSED     0x00080001
+#define GLFW_JOYSTICK_SYSCALLS    0x00080002
+#define GLFW_CONTEXT_SWITCHES     0x00080003
+
+/* GLFWinputevent types */
+#define GLFW_KEY_EVENT            0x00090001
+#define GLFW_CHAR_EVENT           0x00090002
+#define GLFW_MOUSE_BUTTON_EVENT   0x00090003
+#define GLFW_CURSOR_POS_EVENT     0x00090004
+#define GLFW_CURSOR_ENTER_EVENT   0x00090005
+#define GLFW_SCROLL_EVENT         0x00090006
+
 /* Gamma ramps */
 #define GLFW_GAMMA_RAMP_SIZE      256
 
@@ -486,6 +519,8 @@ typedef void (* GLFWcursorenterfun)(GLFWwindow,int);
 typedef void (* GLFWscrollfun)(GLFWwindow,double,double);
 typedef void (* GLFWkeyfun)(GLFWwindow,int,int);
 typedef void (* GLFWcharfun)(GLFWwindow,int);
+typedef void (* GLFWtextfun)(GLFWwindow,const char*);
+typedef void (* GLFWjoystickfun)(int,int);
 
 /* The video mode structure used by glfwGetVideoModes */
 typedef struct
@@ -505,6 +540,36 @@ typedef struct
     unsigned short blue[GLFW_GAMMA_RAMP_SIZE];
 } GLFWgammaramp;
 
+/* Joystick event structure used by glfwGetJoystickEvents */
+typedef struct
+{
+    int type;        /* GLFW_AXIS_EVENT or GLFW_BUTTON_EVENT */
+    int number;      /* Axis or button index */
+    int value;       /* Raw device axis value or GLFW_PRESS/GLFW_RELEASE */
+    float position;  /* Normalized axis position, zero for buttons */
+    double time;     /* Event time in the time base of glfwGetTime */
+} GLFWjoystickevent;
+
+/* Input event structure used by glfwGetInputEvents */
+typedef struct
+{
+    int type;        /* GLFW_KEY_EVENT, GLFW_MOUSE_BUTTON_EVENT, etc. */
+    int code;        /* Key, mouse button or Unicode character */
+    int action;      /* GLFW_PRESS/GLFW_RELEASE, or GL_TRUE if entered */
+    double x;        /* Cursor position or scroll offset */
+    double y;
+    double time;     /* Platform event timestamp in seconds */
+} GLFWinputevent;
+
+/* Frame statistics structure used by glfwGetFrameStats */
+typedef struct
+{
+    double time;       /* Time the last completed swap was presented */
+    unsigned int msc;  /* Vertical retrace count when it was presented */
+    unsigned int sbc;  /* Number of completed swaps */
+    int exact;         /* GL_TRUE if reported by the display system */
+} GLFWframestats;
+
 
 /*************************************************************************
  * Prototypes
@@ -533,6 +598,7 @@ GLFWAPI void glfwSetGammaRamp(const GLFWgammaramp* ramp);
 /* Window handling */
 GLFWAPI GLFWwindow glfwOpenWindow(int width, int height, int mode, const char* title, GLFWwindow share);
 GLFWAPI void glfwOpenWindowHint(int target, int hint);
+GLFWAPI int  glfwOpenSharedContexts(GLFWwindow share, GLFWwindow* contexts, int count);
 GLFWAPI int  glfwIsWindow(GLFWwindow window);
 GLFWAPI void glfwCloseWindow(GLFWwindow window);
 GLFWAPI void glfwSetWindowTitle(GLFWwindow, const char* title);
@@ -554,6 +620,11 @@ GLFWAPI void glfwSetWindowIconifyCallback(GLFWwindowiconifyfun cbfun);
 /* Event handling */
 GLFWAPI void glfwPollEvents(void);
 GLFWAPI void glfwWaitEvents(void);
+GLFWAPI void glfwWaitEventsTimeout(double timeout);
+GLFWAPI void glfwPostEmptyEvent(void);
+
+/* Instrumentation */
+GLFWAPI int  glfwGetCounter(int counter);
 
 /* Input handling */
 GLFWAPI int  glfwGetInputMode(GLFWwindow window, int mode);
@@ -565,15 +636,21 @@ GLFWAPI void glfwSetMousePos(GLFWwindow window, int xpos, int ypos);
 GLFWAPI void glfwGetScrollOffset(GLFWwindow window, double* xoffset, double* yoffset);
 GLFWAPI void glfwSetKeyCallback(GLFWkeyfun cbfun);
 GLFWAPI void glfwSetCharCallback(GLFWcharfun cbfun);
+GLFWAPI void glfwSetTextCallback(GLFWtextfun cbfun);
 GLFWAPI void glfwSetMouseButtonCallback(GLFWmousebuttonfun cbfun);
 GLFWAPI void glfwSetMousePosCallback(GLFWmouseposfun cbfun);
 GLFWAPI void glfwSetCursorEnterCallback(GLFWcursorenterfun cbfun);
 GLFWAPI void glfwSetScrollCallback(GLFWscrollfun cbfun);
+GLFWAPI int  glfwGetInputEvents(GLFWwindow window, GLFWinputevent* events, int maxevents);
 
 /* Joystick input */
 GLFWAPI int glfwGetJoystickParam(int joy, int param);
 GLFWAPI int glfwGetJoystickPos(int joy, float* pos, int numaxes);
 GLFWAPI int glfwGetJoystickButtons(int joy, unsigned char* buttons, int numbuttons);
+/* Joystick event queueing is only supported on Linux; elsewhere
+ * glfwGetJoystickEvents reports GLFW_PLATFORM_ERROR and returns zero */
+GLFWAPI int glfwGetJoystickEvents(int joy, GLFWjoystickevent* events, int maxevents);
+GLFWAPI void glfwSetJoystickCallback(GLFWjoystickfun cbfun);
 
 /* Clipboard */
 GLFWAPI void glfwSetClipboardString(GLFWwindow window, const char* string);
@@ -583,13 +660,21 @@ GLFWAPI const char* glfwGetClipboardString(GLFWwindow window);
 GLFWAPI double glfwGetTime(void);
 GLFWAPI void   glfwSetTime(double time);
 
-/* OpenGL support */
+/* OpenGL support
+ * A context may be current on at most one thread at a time, and each thread
+ * has its own current context.  These functions act on the context current
+ * on the calling thread and, unlike the rest of the API, may be called from
+ * any thread.  A window must not be closed while its context is current on
+ * another thread */
 GLFWAPI void glfwMakeContextCurrent(GLFWwindow window);
 GLFWAPI GLFWwindow glfwGetCurrentContext(void);
 GLFWAPI void  glfwSwapBuffers(void);
 GLFWAPI void  glfwSwapInterval(int interval);
+GLFWAPI int   glfwGetFrameStats(GLFWframestats* stats);
 GLFWAPI int   glfwExtensionSupported(const char* extension);
+GLFWAPI int   glfwExtensionsSupported(const char** extensions, int count, unsigned int* mask);
 GLFWAPI void* glfwGetProcAddress(const char* procname);
+GLFWAPI int   glfwGetProcAddresses(const char** procnames, void** procs, int count);
 GLFWAPI void  glfwCopyContext(GLFWwindow src, GLFWwindow dst, unsigned long mask);
 
 
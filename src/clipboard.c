@@ -51,6 +51,13 @@ GLFWAPI void glfwSetClipboardString(GLFWwindow handle, const char* string)
         return;
     }
 
+    if (window->mode == GLFW_OFFSCREEN)
+    {
+        _glfwSetError(GLFW_INVALID_VALUE,
+                      "glfwSetClipboardString: Offscreen contexts have no window");
+        return;
+    }
+
     _glfwPlatformSetClipboardString(window, string);
 }
 
@@ -69,6 +76,13 @@ GLFWAPI const char* glfwGetClipboardString(GLFWwindow handle)
         return NULL;
     }
 
+    if (window->mode == GLFW_OFFSCREEN)
+    {
+        _glfwSetError(GLFW_INVALID_VALUE,
+                      "glfwGetClipboardString: Offscreen contexts have no window");
+        return NULL;
+    }
+
     return _glfwPlatformGetClipboardString(window);
 }
 
@@ -53,7 +53,7 @@ void _glfwPlatformMakeContextCurrent(_GLFWwindow* window)
 
 void _glfwPlatformSwapBuffers(void)
 {
-    _GLFWwindow* window = _glfwLibrary.currentWindow;
+    _GLFWwindow* window = _glfwCurrentWindow;
 
     // ARP appears to be unnecessary, but this is future-proof
     [window->NSGL.context flushBuffer];
@@ -66,10 +66,24 @@ void _glfwPlatformSwapBuffers(void)
 
 void _glfwPlatformSwapInterval(int interval)
 {
-    _GLFWwindow* window = _glfwLibrary.currentWindow;
+    _GLFWwindow* window = _glfwCurrentWindow;
 
-    GLint sync = interval;
+    // NSGL only supports synchronizing on every retrace or not at all
+    GLint sync = interval != 0;
     [window->NSGL.context setValues:&sync forParameter:NSOpenGLCPSwapInterval];
+    [window->NSGL.context getValues:&sync forParameter:NSOpenGLCPSwapInterval];
+    window->swapInterval = sync;
+}
+
+
+//========================================================================
+// Retrieve statistics about the last completed buffer swap
+//========================================================================
+
+GLboolean _glfwPlatformGetFrameStats(_GLFWwindow* window, GLFWframestats* stats)
+{
+    // There is no NSGL interface for querying presentation times
+    return GL_FALSE;
 }
 
 
@@ -84,6 +98,16 @@ int _glfwPlatformExtensionSupported(const char* extension)
 }
 
 
+//========================================================================
+// Add the platform extensions to the extension set of the specified window
+//========================================================================
+
+void _glfwPlatformAddExtensions(_GLFWwindow* window)
+{
+    // There are no NSGL extensions
+}
+
+
 //========================================================================
 // Get the function pointer to an OpenGL function
 //========================================================================
@@ -503,6 +503,8 @@ static int convertMacKeyCode(unsigned int macKeyCode)
 // down the command key don't get sent to the key window.
 - (void)sendEvent:(NSEvent *)event
 {
+    _glfwLibrary.eventTime = [event timestamp];
+
     if ([event type] == NSKeyUp && ([event modifierFlags] & NSCommandKeyMask))
         [[self keyWindow] sendEvent:event];
     else
@@ -859,6 +861,13 @@ int _glfwPlatformOpenWindow(_GLFWwindow* window,
                             const _GLFWwndconfig* wndconfig,
                             const _GLFWfbconfig* fbconfig)
 {
+    if (wndconfig->mode == GLFW_OFFSCREEN)
+    {
+        _glfwSetError(GLFW_PLATFORM_ERROR,
+                      "Cocoa/NSOpenGL: Offscreen contexts are not supported");
+        return GL_FALSE;
+    }
+
     if (!initializeAppKit())
         return GL_FALSE;
 
@@ -953,7 +962,8 @@ void _glfwPlatformCloseWindow(_GLFWwindow* window)
     [window->NSGL.pixelFormat release];
     window->NSGL.pixelFormat = nil;
 
-    [NSOpenGLContext clearCurrentContext];
+    // The context has already been released by glfwCloseWindow if it was
+    // current, and clearing here would detach any other context
     [window->NSGL.context release];
     window->NSGL.context = nil;
 
@@ -1039,7 +1049,7 @@ void _glfwPlatformRestoreWindow(_GLFWwindow* window)
 void _glfwPlatformRefreshWindowParams(void)
 {
     GLint value;
-    _GLFWwindow* window = _glfwLibrary.currentWindow;
+    _GLFWwindow* window = _glfwCurrentWindow;
 
     // Since GLFW doesn't understand screens, we use virtual screen zero
 
@@ -1101,6 +1111,10 @@ void _glfwPlatformRefreshWindowParams(void)
                        forVirtualScreen:0];
     window->samples = value;
 
+    [window->NSGL.context getValues:&value forParameter:NSOpenGLCPSwapInterval];
+    window->swapInterval = value;
+    window->swapControl = GLFW_SWAP_INTERVAL_BIT | GLFW_SWAP_IMMEDIATE_BIT;
+
     // These this is forced to false as long as Mac OS X lacks support for
     // requesting debug contexts
     window->glDebug = GL_FALSE;
@@ -1123,7 +1137,10 @@ void _glfwPlatformPollEvents(void)
                                      dequeue:YES];
 
         if (event)
+        {
             [NSApp sendEvent:event];
+            _glfwLibrary.eventCount++;
+        }
     }
     while (event);
 
@@ -1146,11 +1163,57 @@ void _glfwPlatformWaitEvents( void )
                                            inMode:NSDefaultRunLoopMode
                                           dequeue:YES];
     [NSApp sendEvent:event];
+    _glfwLibrary.eventCount++;
 
     _glfwPlatformPollEvents();
 }
 
 
+//========================================================================
+// Wait for new window and input events or until the timeout has elapsed
+//========================================================================
+
+void _glfwPlatformWaitEventsTimeout(double timeout)
+{
+    NSDate* date = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    NSEvent* event = [NSApp nextEventMatchingMask:NSAnyEventMask
+                                        untilDate:date
+                                           inMode:NSDefaultRunLoopMode
+                                          dequeue:YES];
+    if (event)
+    {
+        [NSApp sendEvent:event];
+        _glfwLibrary.eventCount++;
+    }
+
+    _glfwPlatformPollEvents();
+}
+
+
+//========================================================================
+// Post an empty event to wake up a thread waiting for events
+//========================================================================
+
+void _glfwPlatformPostEmptyEvent(void)
+{
+    // This may be called from a thread without an autorelease pool
+    NSAutoreleasePool* pool = [[NSAutoreleasePool alloc] init];
+
+    NSEvent* event = [NSEvent otherEventWithType:NSApplicationDefined
+                                        location:NSMakePoint(0, 0)
+                                   modifierFlags:0
+                                       timestamp:0
+                                    windowNumber:0
+                                         context:nil
+                                         subtype:0
+                                           data1:0
+                                           data2:0];
+    [NSApp postEvent:event atStart:YES];
+
+    [pool drain];
+}
+
+
 //========================================================================
 // Set physical mouse cursor position
 //========================================================================
@@ -38,9 +38,11 @@
 // The current error value and callback
 // These are not in _glfwLibrary since they need to be initialized and
 // accessible before glfwInit so it can report errors
+// The error value is per thread, so that errors are reported to the thread
+// that caused them
 //========================================================================
 
-static int _glfwError = GLFW_NO_ERROR;
+static _GLFW_TLS int _glfwError = GLFW_NO_ERROR;
 static GLFWerrorfun _glfwErrorCallback = NULL;
 
 
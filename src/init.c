@@ -84,6 +84,8 @@ GLFWAPI void glfwTerminate(void)
     if (!_glfwPlatformTerminate())
         return;
 
+    _glfwFreeProcCache();
+
     _glfwInitialized = GL_FALSE;
 }
 
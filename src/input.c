@@ -30,6 +30,12 @@
 
 #include "internal.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+// Number of events each window input queue can hold
+#define _GLFW_INPUT_QUEUE_SIZE 1024
+
 
 //========================================================================
 // Sets the cursor mode for the specified window
@@ -47,7 +53,8 @@ static void setCursorMode(_GLFWwindow* window, int mode)
         return;
     }
 
-    if (window->cursorMode == mode)
+    // Offscreen contexts have no window and so no cursor
+    if (window->cursorMode == mode || window->mode == GLFW_OFFSCREEN)
         return;
 
     centerPosX = window->width / 2;
@@ -125,7 +132,7 @@ static void setStickyMouseButtons(_GLFWwindow* window, int enabled)
 
 static void setSystemKeys(_GLFWwindow* window, int enabled)
 {
-    if (window->systemKeys == enabled)
+    if (window->systemKeys == enabled || window->mode == GLFW_OFFSCREEN)
         return;
 
     if (enabled)
@@ -147,6 +154,123 @@ static void setKeyRepeat(_GLFWwindow* window, int enabled)
 }
 
 
+//========================================================================
+// Add an input event that happened at the specified time to the input
+// queue of the specified window
+// The event is dropped if the queue is disabled or full
+//========================================================================
+
+static void queueTimedInputEvent(_GLFWwindow* window, int type, int code,
+                                 int action, double x, double y, double time)
+{
+    GLFWinputevent* event;
+    const int head = window->inputQueueHead;
+    const int next = (head + 1) % _GLFW_INPUT_QUEUE_SIZE;
+
+    if (!window->inputQueueEnabled)
+        return;
+
+    if (next == window->inputQueueTail)
+        return;
+
+    event = window->inputQueue + head;
+    event->type = type;
+    event->code = code;
+    event->action = action;
+    event->x = x;
+    event->y = y;
+    event->time = time;
+
+    // Make sure the event is written before it is made visible
+    _GLFW_MEMORY_BARRIER();
+
+    window->inputQueueHead = next;
+}
+
+
+//========================================================================
+// Add an input event that happened at the time of the event currently
+// being processed to the input queue of the specified window
+//========================================================================
+
+static void queueInputEvent(_GLFWwindow* window, int type, int code,
+                            int action, double x, double y)
+{
+    queueTimedInputEvent(window, type, code, action, x, y,
+                         _glfwLibrary.eventTime);
+}
+
+
+//========================================================================
+// Set the input event queue for the specified window
+// Disabling the queue only stops events from being added, as another
+// thread may still be draining it, so the buffer is kept until the window
+// is destroyed and reused if the queue is enabled again
+//========================================================================
+
+static void setInputQueue(_GLFWwindow* window, int enabled)
+{
+    if (enabled && !window->inputQueue)
+    {
+        window->inputQueue = (GLFWinputevent*)
+            malloc(sizeof(GLFWinputevent) * _GLFW_INPUT_QUEUE_SIZE);
+        if (!window->inputQueue)
+        {
+            _glfwSetError(GLFW_OUT_OF_MEMORY,
+                          "glfwSetInputMode: Failed to allocate input queue");
+            return;
+        }
+
+        window->inputQueueHead = 0;
+        window->inputQueueTail = 0;
+    }
+
+    window->inputQueueEnabled = enabled;
+}
+
+
+//========================================================================
+// Report any coalesced cursor motion for the specified window
+//========================================================================
+
+static void flushCursorMotion(_GLFWwindow* window)
+{
+    if (!window->cursorMoved)
+        return;
+
+    window->cursorMoved = GL_FALSE;
+
+    // The event is stamped with the time of the last motion it represents,
+    // not the time it is flushed
+    queueTimedInputEvent(window, GLFW_CURSOR_POS_EVENT, 0, 0,
+                         window->cursorPosX, window->cursorPosY,
+                         window->cursorMovedTime);
+
+    if (_glfwLibrary.mousePosCallback)
+    {
+        _glfwLibrary.mousePosCallback(window,
+                                      window->cursorPosX,
+                                      window->cursorPosY);
+    }
+}
+
+
+//========================================================================
+// Set cursor motion coalescing for the specified window
+//========================================================================
+
+static void setMotionCoalescing(_GLFWwindow* window, int enabled)
+{
+    if (window->coalesceMotion == enabled)
+        return;
+
+    if (!enabled)
+        flushCursorMotion(window);
+
+    window->coalesceMotion = enabled;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW internal API                      //////
 //////////////////////////////////////////////////////////////////////////
@@ -162,6 +286,9 @@ void _glfwInputKey(_GLFWwindow* window, int key, int action)
     if (key < 0 || key > GLFW_KEY_LAST)
         return;
 
+    // Report coalesced motion first to preserve the order of events
+    flushCursorMotion(window);
+
     // Are we trying to release an already released key?
     if (action == GLFW_RELEASE && window->key[key] != GLFW_PRESS)
         return;
@@ -175,24 +302,182 @@ void _glfwInputKey(_GLFWwindow* window, int key, int action)
         window->key[key] = (char) action;
     }
 
+    if (repeated && !window->keyRepeat)
+        return;
+
+    queueInputEvent(window, GLFW_KEY_EVENT, key, action, 0.0, 0.0);
+
     // Call user callback function
-    if (_glfwLibrary.keyCallback && (window->keyRepeat || !repeated))
+    if (_glfwLibrary.keyCallback)
         _glfwLibrary.keyCallback(window, key, action);
 }
 
 
 //========================================================================
-// Register (keyboard) character activity
+// Register a single character, returning GL_FALSE if it was discarded
 //========================================================================
 
-void _glfwInputChar(_GLFWwindow* window, int character)
+static GLboolean inputChar(_GLFWwindow* window, int character)
 {
     // Valid Unicode (ISO 10646) character?
     if (!((character >= 32 && character <= 126) || character >= 160))
-        return;
+        return GL_FALSE;
+
+    queueInputEvent(window, GLFW_CHAR_EVENT, character, 0, 0.0, 0.0);
 
     if (_glfwLibrary.charCallback)
         _glfwLibrary.charCallback(window, character);
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Encode a Unicode code point as UTF-8, returning the number of bytes
+//========================================================================
+
+static int encodeUTF8(char* s, int character)
+{
+    if (character < 0x80)
+    {
+        s[0] = (char) character;
+        return 1;
+    }
+    else if (character < 0x800)
+    {
+        s[0] = (char) (0xc0 | (character >> 6));
+        s[1] = (char) (0x80 | (character & 0x3f));
+        return 2;
+    }
+    else if (character < 0x10000)
+    {
+        s[0] = (char) (0xe0 | (character >> 12));
+        s[1] = (char) (0x80 | ((character >> 6) & 0x3f));
+        s[2] = (char) (0x80 | (character & 0x3f));
+        return 3;
+    }
+    else
+    {
+        s[0] = (char) (0xf0 | (character >> 18));
+        s[1] = (char) (0x80 | ((character >> 12) & 0x3f));
+        s[2] = (char) (0x80 | ((character >> 6) & 0x3f));
+        s[3] = (char) (0x80 | (character & 0x3f));
+        return 4;
+    }
+}
+
+
+//========================================================================
+// Decode the UTF-8 sequence at the start of the specified string,
+// returning the number of bytes it spans and -1 as the code point if the
+// sequence is invalid
+//========================================================================
+
+static int decodeUTF8(const char* s, int length, int* character)
+{
+    int i, count;
+    const unsigned char* u = (const unsigned char*) s;
+
+    if (u[0] < 0x80)
+    {
+        *character = u[0];
+        return 1;
+    }
+    else if (u[0] >= 0xc2 && u[0] < 0xe0)
+    {
+        *character = u[0] & 0x1f;
+        count = 2;
+    }
+    else if (u[0] >= 0xe0 && u[0] < 0xf0)
+    {
+        *character = u[0] & 0x0f;
+        count = 3;
+    }
+    else if (u[0] >= 0xf0 && u[0] < 0xf5)
+    {
+        *character = u[0] & 0x07;
+        count = 4;
+    }
+    else
+    {
+        *character = -1;
+        return 1;
+    }
+
+    for (i = 1;  i < count;  i++)
+    {
+        if (i >= length || (u[i] & 0xc0) != 0x80)
+        {
+            *character = -1;
+            return i;
+        }
+
+        *character = (*character << 6) | (u[i] & 0x3f);
+    }
+
+    // Reject overlong encodings, surrogates and code points past Unicode
+    if ((count == 3 && *character < 0x800) ||
+        (count == 4 && *character < 0x10000) ||
+        (*character >= 0xd800 && *character <= 0xdfff) ||
+        *character > 0x10ffff)
+    {
+        *character = -1;
+    }
+
+    return count;
+}
+
+
+//========================================================================
+// Register (keyboard) character activity
+//========================================================================
+
+void _glfwInputChar(_GLFWwindow* window, int character)
+{
+    char text[5];
+
+    if (!inputChar(window, character))
+        return;
+
+    if (_glfwLibrary.textCallback)
+    {
+        text[encodeUTF8(text, character)] = '\0';
+        _glfwLibrary.textCallback(window, text);
+    }
+}
+
+
+//========================================================================
+// Register a string of committed text, such as the result of a compose
+// sequence or an input method conversion
+// A character event is generated for each valid character, but the text
+// callback is called only once for the whole string
+// NOTE: The text is filtered in place and then terminated, so the buffer
+//       must have room for length + 1 bytes
+//========================================================================
+
+void _glfwInputText(_GLFWwindow* window, char* text, int length)
+{
+    int character, size, read = 0, written = 0;
+
+    while (read < length)
+    {
+        size = decodeUTF8(text + read, length - read, &character);
+
+        if (character != -1 && inputChar(window, character))
+        {
+            memmove(text + written, text + read, size);
+            written += size;
+        }
+
+        read += size;
+    }
+
+    if (written && _glfwLibrary.textCallback)
+    {
+        text[written] = '\0';
+        _glfwLibrary.textCallback(window, text);
+    }
 }
 
 
@@ -202,9 +487,13 @@ void _glfwInputChar(_GLFWwindow* window, int character)
 
 void _glfwInputScroll(_GLFWwindow* window, double xoffset, double yoffset)
 {
+    flushCursorMotion(window);
+
     window->scrollX += xoffset;
     window->scrollY += yoffset;
 
+    queueInputEvent(window, GLFW_SCROLL_EVENT, 0, 0, xoffset, yoffset);
+
     if (_glfwLibrary.scrollCallback)
         _glfwLibrary.scrollCallback(window, xoffset, yoffset);
 }
@@ -219,12 +508,17 @@ void _glfwInputMouseClick(_GLFWwindow* window, int button, int action)
     if (button < 0 || button > GLFW_MOUSE_BUTTON_LAST)
         return;
 
+    flushCursorMotion(window);
+
     // Register mouse button action
     if (action == GLFW_RELEASE && window->stickyMouseButtons)
         window->mouseButton[button] = GLFW_STICK;
     else
         window->mouseButton[button] = (char) action;
 
+    queueInputEvent(window, GLFW_MOUSE_BUTTON_EVENT, button, action,
+                    window->cursorPosX, window->cursorPosY);
+
     if (_glfwLibrary.mouseButtonCallback)
         _glfwLibrary.mouseButtonCallback(window, button, action);
 }
@@ -253,6 +547,18 @@ void _glfwInputCursorMotion(_GLFWwindow* window, int x, int y)
         window->cursorPosY = y;
     }
 
+    if (window->coalesceMotion)
+    {
+        // The callback is called once with the final position, either before
+        // the next non-motion input event or at the end of the event poll
+        window->cursorMoved = GL_TRUE;
+        window->cursorMovedTime = _glfwLibrary.eventTime;
+        return;
+    }
+
+    queueInputEvent(window, GLFW_CURSOR_POS_EVENT, 0, 0,
+                    window->cursorPosX, window->cursorPosY);
+
     if (_glfwLibrary.mousePosCallback)
     {
         _glfwLibrary.mousePosCallback(window,
@@ -268,11 +574,29 @@ void _glfwInputCursorMotion(_GLFWwindow* window, int x, int y)
 
 void _glfwInputCursorEnter(_GLFWwindow* window, int entered)
 {
+    flushCursorMotion(window);
+
+    queueInputEvent(window, GLFW_CURSOR_ENTER_EVENT, 0, entered,
+                    window->cursorPosX, window->cursorPosY);
+
     if (_glfwLibrary.cursorEnterCallback)
         _glfwLibrary.cursorEnterCallback(window, entered);
 }
 
 
+//========================================================================
+// Report coalesced cursor motion for all windows
+//========================================================================
+
+void _glfwFlushCursorMotion(void)
+{
+    _GLFWwindow* window;
+
+    for (window = _glfwLibrary.windowListHead;  window;  window = window->next)
+        flushCursorMotion(window);
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                        GLFW public API                       //////
 //////////////////////////////////////////////////////////////////////////
@@ -303,6 +627,10 @@ GLFWAPI int glfwGetInputMode(GLFWwindow handle, int mode)
             return window->systemKeys;
         case GLFW_KEY_REPEAT:
             return window->keyRepeat;
+        case GLFW_MOTION_COALESCING:
+            return window->coalesceMotion;
+        case GLFW_INPUT_QUEUE:
+            return window->inputQueueEnabled;
         default:
             _glfwSetError(GLFW_INVALID_ENUM, NULL);
             return 0;
@@ -341,6 +669,12 @@ GLFWAPI void glfwSetInputMode(GLFWwindow handle, int mode, int value)
         case GLFW_KEY_REPEAT:
             setKeyRepeat(window, value ? GL_TRUE : GL_FALSE);
             break;
+        case GLFW_MOTION_COALESCING:
+            setMotionCoalescing(window, value ? GL_TRUE : GL_FALSE);
+            break;
+        case GLFW_INPUT_QUEUE:
+            setInputQueue(window, value ? GL_TRUE : GL_FALSE);
+            break;
         default:
             _glfwSetError(GLFW_INVALID_ENUM, NULL);
             break;
@@ -526,6 +860,22 @@ GLFWAPI void glfwSetCharCallback(GLFWcharfun cbfun)
 }
 
 
+//========================================================================
+// Set callback function for text input
+//========================================================================
+
+GLFWAPI void glfwSetTextCallback(GLFWtextfun cbfun)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    _glfwLibrary.textCallback = cbfun;
+}
+
+
 //========================================================================
 // Set callback function for mouse clicks
 //========================================================================
@@ -599,3 +949,48 @@ GLFWAPI void glfwSetScrollCallback(GLFWscrollfun cbfun)
     _glfwLibrary.scrollCallback = cbfun;
 }
 
+
+//========================================================================
+// Retrieve buffered input events for the specified window
+// This may be called from a thread other than the one processing events
+// Events queued before the queue was disabled can still be retrieved
+//========================================================================
+
+GLFWAPI int glfwGetInputEvents(GLFWwindow handle, GLFWinputevent* events, int maxevents)
+{
+    _GLFWwindow* window = (_GLFWwindow*) handle;
+    int count, tail, head;
+
+    if (!_glfwInitialized)
+    {
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
+        return 0;
+    }
+
+    if (!window->inputQueue)
+    {
+        _glfwSetError(GLFW_INVALID_VALUE,
+                      "glfwGetInputEvents: The input queue has never been enabled");
+        return 0;
+    }
+
+    head = window->inputQueueHead;
+    tail = window->inputQueueTail;
+
+    // Make sure the events are read after the head they were published with
+    _GLFW_MEMORY_BARRIER();
+
+    for (count = 0;  count < maxevents && tail != head;  count++)
+    {
+        events[count] = window->inputQueue[tail];
+        tail = (tail + 1) % _GLFW_INPUT_QUEUE_SIZE;
+    }
+
+    // Make sure the events are copied before their slots can be reused
+    _GLFW_MEMORY_BARRIER();
+
+    window->inputQueueTail = tail;
+
+    return count;
+}
+
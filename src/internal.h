@@ -75,6 +75,28 @@
  #error "No supported platform selected"
 #endif
 
+// Full memory barrier, used by the single-producer single-consumer input
+// event queue
+#if defined(_MSC_VER)
+ #define _GLFW_MEMORY_BARRIER() MemoryBarrier()
+#else
+ #define _GLFW_MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+// Atomic increment, used by counters that any thread may update
+#if defined(_MSC_VER)
+ #define _GLFW_ATOMIC_INCREMENT(x) InterlockedIncrement(&(x))
+#else
+ #define _GLFW_ATOMIC_INCREMENT(x) __sync_fetch_and_add(&(x), 1)
+#endif
+
+// Storage class for variables with a separate instance in every thread
+#if defined(_MSC_VER)
+ #define _GLFW_TLS __declspec(thread)
+#else
+ #define _GLFW_TLS __thread
+#endif
+
 typedef struct _GLFWhints _GLFWhints;
 typedef struct _GLFWwndconfig _GLFWwndconfig;
 typedef struct _GLFWfbconfig _GLFWfbconfig;
@@ -174,7 +196,7 @@ struct _GLFWwindow
     GLboolean closeRequested;  // GL_TRUE if this window should be closed
     int       width, height;
     int       positionX, positionY;
-    int       mode;            // GLFW_WINDOW or GLFW_FULLSCREEN
+    int       mode;            // GLFW_WINDOWED, GLFW_FULLSCREEN or GLFW_OFFSCREEN
     GLboolean resizable;       // GL_TRUE if user may resize this window
     int       refreshRate;     // monitor refresh rate
     void*     userPointer;
@@ -184,12 +206,23 @@ struct _GLFWwindow
     GLboolean stickyMouseButtons;
     GLboolean keyRepeat;
     GLboolean systemKeys;      // system keys enabled flag
+    GLboolean coalesceMotion;  // GL_TRUE if cursor motion is reported per poll
+    GLboolean cursorMoved;     // GL_TRUE if coalesced motion is unreported
+    double    cursorMovedTime; // time of the last coalesced motion
     int       cursorPosX, cursorPosY;
     int       cursorMode;
     double    scrollX, scrollY;
     char      mouseButton[GLFW_MOUSE_BUTTON_LAST + 1];
     char      key[GLFW_KEY_LAST + 1];
 
+    // Buffered input events, or NULL if the input queue was never enabled
+    // Event processing only ever writes the head and glfwGetInputEvents
+    // only ever writes the tail, so the queue needs no lock
+    GLboolean       inputQueueEnabled;
+    GLFWinputevent* inputQueue;
+    volatile int    inputQueueHead;
+    volatile int    inputQueueTail;
+
     // Framebuffer attributes
     int       redBits;
     int       greenBits;
@@ -213,6 +246,23 @@ struct _GLFWwindow
     int       glRobustness;
     PFNGLGETSTRINGIPROC GetStringi;
 
+    // Swap interval in effect and GLFW_SWAP_CONTROL bits for the supported
+    // kinds of interval
+    int       swapInterval;
+    int       swapControl;
+
+    // Swap count and time of the last swap, used for frame statistics when
+    // the platform cannot report when frames are presented
+    unsigned int swapCount;
+    double    swapTime;
+
+    // Hash set of the GL and platform extensions supported by the context,
+    // built on the first extension query and kept until the window closes
+    char*         extensionNames;  // Space separated, then NUL terminated
+    size_t        extensionLength;
+    unsigned int* extensionSlots;  // Offset plus one into the names, or 0
+    unsigned int  extensionMask;   // Number of slots minus one
+
     // These are defined in the current port's platform.h
     _GLFW_PLATFORM_WINDOW_STATE;
     _GLFW_PLATFORM_CONTEXT_STATE;
@@ -227,7 +277,6 @@ struct _GLFWlibrary
     _GLFWhints    hints;
 
     _GLFWwindow*  windowListHead;
-    _GLFWwindow*  currentWindow;
     _GLFWwindow*  activeWindow;
 
     GLFWwindowsizefun    windowSizeCallback;
@@ -241,6 +290,32 @@ struct _GLFWlibrary
     GLFWscrollfun        scrollCallback;
     GLFWkeyfun           keyCallback;
     GLFWcharfun          charCallback;
+    GLFWtextfun          textCallback;
+    GLFWjoystickfun      joystickCallback;
+
+    // Number of events processed by the last call to glfwPollEvents or
+    // glfwWaitEvents, incremented by the platform event processing
+    int           eventCount;
+
+    // Platform timestamp, in seconds, of the event currently being
+    // processed, used for buffered input events
+    double        eventTime;
+
+    // Number of joystick system calls made since the last call to
+    // glfwPollEvents or glfwWaitEvents, incremented by the platform
+    int           joystickSyscalls;
+
+    // Number of context switches made by glfwMakeContextCurrent on any
+    // thread since the last call to glfwPollEvents or glfwWaitEvents
+    volatile long contextSwitches;
+
+    // Cache of resolved OpenGL entry points, keyed by name
+    struct {
+        char**        names;
+        void**        procs;
+        unsigned int  count;
+        unsigned int  mask;  // Number of slots minus one
+    } procCache;
 
     GLFWgammaramp currentRamp;
     GLFWgammaramp originalRamp;
@@ -265,6 +340,9 @@ GLFWGLOBAL GLboolean _glfwInitialized;
 
 GLFWGLOBAL _GLFWlibrary _glfwLibrary;
 
+// Window whose context is current on the calling thread
+GLFWGLOBAL _GLFW_TLS _GLFWwindow* _glfwCurrentWindow;
+
 
 //========================================================================
 // Prototypes for platform specific implementation functions
@@ -297,6 +375,7 @@ const char* _glfwPlatformGetClipboardString(_GLFWwindow* window);
 int _glfwPlatformGetJoystickParam(int joy, int param);
 int _glfwPlatformGetJoystickPos(int joy, float* pos, int numaxes);
 int _glfwPlatformGetJoystickButtons(int joy, unsigned char* buttons, int numbuttons);
+int _glfwPlatformGetJoystickEvents(int joy, GLFWjoystickevent* events, int maxevents);
 
 // Time
 double _glfwPlatformGetTime(void);
@@ -314,13 +393,17 @@ void _glfwPlatformRestoreWindow(_GLFWwindow* window);
 // Event management
 void _glfwPlatformPollEvents(void);
 void _glfwPlatformWaitEvents(void);
+void _glfwPlatformWaitEventsTimeout(double timeout);
+void _glfwPlatformPostEmptyEvent(void);
 
 // OpenGL context management
 void _glfwPlatformMakeContextCurrent(_GLFWwindow* window);
 void _glfwPlatformSwapBuffers(void);
 void _glfwPlatformSwapInterval(int interval);
+GLboolean _glfwPlatformGetFrameStats(_GLFWwindow* window, GLFWframestats* stats);
 void _glfwPlatformRefreshWindowParams(void);
 int  _glfwPlatformExtensionSupported(const char* extension);
+void _glfwPlatformAddExtensions(_GLFWwindow* window);
 void* _glfwPlatformGetProcAddress(const char* procname);
 void _glfwPlatformCopyContext(_GLFWwindow* src, _GLFWwindow* dst, unsigned long mask);
 
@@ -348,13 +431,25 @@ void _glfwInputWindowDamage(_GLFWwindow* window);
 // Input event notification (input.c)
 void _glfwInputKey(_GLFWwindow* window, int key, int action);
 void _glfwInputChar(_GLFWwindow* window, int character);
+void _glfwInputText(_GLFWwindow* window, char* text, int length);
 void _glfwInputScroll(_GLFWwindow* window, double x, double y);
 void _glfwInputMouseClick(_GLFWwindow* window, int button, int action);
 void _glfwInputCursorMotion(_GLFWwindow* window, int x, int y);
 void _glfwInputCursorEnter(_GLFWwindow* window, int entered);
+void _glfwFlushCursorMotion(void);
+
+// Joystick event notification (joystick.c)
+void _glfwInputJoystick(int joy, int event);
 
 // OpenGL context helpers (opengl.c)
 int _glfwStringInExtensionString(const char* string, const GLubyte* extensions);
+void _glfwAddExtensionString(_GLFWwindow* window, const char* extensions);
+void _glfwFreeProcCache(void);
+int* _glfwTransposeFBConfigs(const _GLFWfbconfig* configs, unsigned int count);
+unsigned int _glfwRankFBConfigs(const _GLFWfbconfig* desired,
+                                const int* columns,
+                                unsigned int count,
+                                unsigned int* ranking);
 const _GLFWfbconfig* _glfwChooseFBConfig(const _GLFWfbconfig* desired,
                                          const _GLFWfbconfig* alternatives,
                                          unsigned int count);
@@ -31,6 +31,21 @@
 #include "internal.h"
 
 
+//////////////////////////////////////////////////////////////////////////
+//////                       GLFW internal API                      //////
+//////////////////////////////////////////////////////////////////////////
+
+//========================================================================
+// Register a joystick being connected or disconnected
+//========================================================================
+
+void _glfwInputJoystick(int joy, int event)
+{
+    if (_glfwLibrary.joystickCallback)
+        _glfwLibrary.joystickCallback(joy, event);
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                        GLFW public API                       //////
 //////////////////////////////////////////////////////////////////////////
@@ -47,6 +62,12 @@ GLFWAPI int glfwGetJoystickParam(int joy, int param)
         return 0;
     }
 
+    if (joy < 0 || joy > GLFW_JOYSTICK_LAST)
+    {
+        _glfwSetError(GLFW_INVALID_ENUM, NULL);
+        return 0;
+    }
+
     return _glfwPlatformGetJoystickParam(joy, param);
 }
 
@@ -65,6 +86,12 @@ GLFWAPI int glfwGetJoystickPos(int joy, float* pos, int numaxes)
         return 0;
     }
 
+    if (joy < 0 || joy > GLFW_JOYSTICK_LAST)
+    {
+        _glfwSetError(GLFW_INVALID_ENUM, NULL);
+        return 0;
+    }
+
     // Clear positions
     for (i = 0;  i < numaxes;  i++)
         pos[i] = 0.0f;
@@ -89,6 +116,12 @@ GLFWAPI int glfwGetJoystickButtons(int joy,
         return 0;
     }
 
+    if (joy < 0 || joy > GLFW_JOYSTICK_LAST)
+    {
+        _glfwSetError(GLFW_INVALID_ENUM, NULL);
+        return 0;
+    }
+
     // Clear button states
     for (i = 0;  i < numbuttons;  i++)
         buttons[i] = GLFW_RELEASE;
@@ -96,3 +129,46 @@ GLFWAPI int glfwGetJoystickButtons(int joy,
     return _glfwPlatformGetJoystickButtons(joy, buttons, numbuttons);
 }
 
+
+//========================================================================
+// Get queued joystick events
+//========================================================================
+
+GLFWAPI int glfwGetJoystickEvents(int joy,
+                                  GLFWjoystickevent* events,
+                                  int maxevents)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
+        return 0;
+    }
+
+    if (joy < 0 || joy > GLFW_JOYSTICK_LAST)
+    {
+        _glfwSetError(GLFW_INVALID_ENUM, NULL);
+        return 0;
+    }
+
+    if (maxevents <= 0)
+        return 0;
+
+    return _glfwPlatformGetJoystickEvents(joy, events, maxevents);
+}
+
+
+//========================================================================
+// Set callback function for joystick connection and disconnection
+//========================================================================
+
+GLFWAPI void glfwSetJoystickCallback(GLFWjoystickfun cbfun)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    _glfwLibrary.joystickCallback = cbfun;
+}
+
@@ -31,8 +31,476 @@
 #include "internal.h"
 
 #include <string.h>
+#include <stdlib.h>
 #include <limits.h>
 
+#if !defined(_GLFW_WIN32_WGL)
+ #include <pthread.h>
+#endif
+
+
+//========================================================================
+// Framebuffer configuration score columns, lower is better
+//========================================================================
+
+enum
+{
+    SCORE_MISSING,
+    SCORE_COLOR_DIFF,
+    SCORE_EXTRA_DIFF,
+    _GLFW_FBCONFIG_SCORES
+};
+
+
+//========================================================================
+// Stably sort the specified indices by one byte of the specified score
+// column, using the scratch array for the result
+// Returns GL_FALSE, leaving both arrays untouched, if all scores have the
+// same value for that byte and so are already sorted by it
+//========================================================================
+
+static GLboolean sortByScoreByte(const unsigned int* scores,
+                                 const unsigned int* indices,
+                                 unsigned int count,
+                                 int shift,
+                                 unsigned int* scratch)
+{
+    unsigned int i, total = 0;
+    unsigned int offsets[256];
+
+    memset(offsets, 0, sizeof(offsets));
+
+    for (i = 0;  i < count;  i++)
+        offsets[(scores[indices[i]] >> shift) & 0xff]++;
+
+    if (offsets[(scores[indices[0]] >> shift) & 0xff] == count)
+        return GL_FALSE;
+
+    for (i = 0;  i < 256;  i++)
+    {
+        const unsigned int size = offsets[i];
+        offsets[i] = total;
+        total += size;
+    }
+
+    for (i = 0;  i < count;  i++)
+        scratch[offsets[(scores[indices[i]] >> shift) & 0xff]++] = indices[i];
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Framebuffer configuration attribute columns, in the order they are
+// stored in by _glfwTransposeFBConfigs
+//========================================================================
+
+enum
+{
+    ATTRIB_RED,
+    ATTRIB_GREEN,
+    ATTRIB_BLUE,
+    ATTRIB_ALPHA,
+    ATTRIB_DEPTH,
+    ATTRIB_STENCIL,
+    ATTRIB_ACCUM_RED,
+    ATTRIB_ACCUM_GREEN,
+    ATTRIB_ACCUM_BLUE,
+    ATTRIB_ACCUM_ALPHA,
+    ATTRIB_AUX_BUFFERS,
+    ATTRIB_STEREO,
+    ATTRIB_SAMPLES,
+    _GLFW_FBCONFIG_ATTRIBS
+};
+
+
+//========================================================================
+// Add the specified weight to the score of every candidate lacking the
+// attribute of the specified column
+//========================================================================
+
+static void addMissing(unsigned int* score, const int* column,
+                       unsigned int count, unsigned int weight)
+{
+    unsigned int i;
+
+    for (i = 0;  i < count;  i++)
+        score[i] += weight * (column[i] == 0);
+}
+
+
+//========================================================================
+// Add the squared difference between the desired value and the value of
+// every candidate in the specified column to its score
+//========================================================================
+
+static void addDiff(unsigned int* score, const int* column,
+                    unsigned int count, int desired)
+{
+    unsigned int i;
+
+    for (i = 0;  i < count;  i++)
+    {
+        const int diff = desired - column[i];
+        score[i] += (unsigned int) (diff * diff);
+    }
+}
+
+
+//========================================================================
+// Score the framebuffer configurations in the specified attribute columns
+// against the desired one
+// The scores array holds _GLFW_FBCONFIG_SCORES columns of count entries
+// Stereo is a hard constraint and disqualifies a candidate by scoring it
+// at least UINT_MAX / 2 missing buffers
+//========================================================================
+
+static void scoreFBConfigs(const _GLFWfbconfig* desired,
+                           const int* columns,
+                           unsigned int count,
+                           unsigned int* scores)
+{
+    unsigned int i;
+    unsigned int* missing = scores + count * SCORE_MISSING;
+    unsigned int* colorDiff = scores + count * SCORE_COLOR_DIFF;
+    unsigned int* extraDiff = scores + count * SCORE_EXTRA_DIFF;
+
+#define COLUMN(attrib) (columns + count * (attrib))
+
+    memset(scores, 0, sizeof(unsigned int) * count * _GLFW_FBCONFIG_SCORES);
+
+    // Each requested attribute is scored by its own branchless pass over
+    // one column; attributes that were not requested are skipped entirely
+
+    // Count number of missing buffers
+    // Technically, several multisampling buffers could be involved,
+    // but that's a lower level implementation detail and not important
+    // to us here, so we count them as one
+    if (desired->stereo > 0)
+        addMissing(missing, COLUMN(ATTRIB_STEREO), count, UINT_MAX / 2);
+    if (desired->alphaBits > 0)
+        addMissing(missing, COLUMN(ATTRIB_ALPHA), count, 1);
+    if (desired->depthBits > 0)
+        addMissing(missing, COLUMN(ATTRIB_DEPTH), count, 1);
+    if (desired->stencilBits > 0)
+        addMissing(missing, COLUMN(ATTRIB_STENCIL), count, 1);
+    if (desired->samples > 0)
+        addMissing(missing, COLUMN(ATTRIB_SAMPLES), count, 1);
+
+    if (desired->auxBuffers > 0)
+    {
+        const int* aux = COLUMN(ATTRIB_AUX_BUFFERS);
+
+        for (i = 0;  i < count;  i++)
+        {
+            const int lacking = desired->auxBuffers - aux[i];
+            missing[i] += (lacking > 0) * lacking;
+        }
+    }
+
+    // These polynomials make many small channel size differences
+    // matter less than one large channel size difference
+    if (desired->redBits > 0)
+        addDiff(colorDiff, COLUMN(ATTRIB_RED), count, desired->redBits);
+    if (desired->greenBits > 0)
+        addDiff(colorDiff, COLUMN(ATTRIB_GREEN), count, desired->greenBits);
+    if (desired->blueBits > 0)
+        addDiff(colorDiff, COLUMN(ATTRIB_BLUE), count, desired->blueBits);
+
+    if (desired->alphaBits > 0)
+        addDiff(extraDiff, COLUMN(ATTRIB_ALPHA), count, desired->alphaBits);
+    if (desired->depthBits > 0)
+        addDiff(extraDiff, COLUMN(ATTRIB_DEPTH), count, desired->depthBits);
+    if (desired->stencilBits > 0)
+        addDiff(extraDiff, COLUMN(ATTRIB_STENCIL), count, desired->stencilBits);
+    if (desired->accumRedBits > 0)
+        addDiff(extraDiff, COLUMN(ATTRIB_ACCUM_RED), count, desired->accumRedBits);
+    if (desired->accumGreenBits > 0)
+        addDiff(extraDiff, COLUMN(ATTRIB_ACCUM_GREEN), count, desired->accumGreenBits);
+    if (desired->accumBlueBits > 0)
+        addDiff(extraDiff, COLUMN(ATTRIB_ACCUM_BLUE), count, desired->accumBlueBits);
+    if (desired->accumAlphaBits > 0)
+        addDiff(extraDiff, COLUMN(ATTRIB_ACCUM_ALPHA), count, desired->accumAlphaBits);
+    if (desired->samples > 0)
+        addDiff(extraDiff, COLUMN(ATTRIB_SAMPLES), count, desired->samples);
+
+#undef COLUMN
+}
+
+
+//========================================================================
+// Hash a name of the specified length (FNV-1a)
+//========================================================================
+
+static unsigned int hashName(const char* name, size_t length)
+{
+    size_t i;
+    unsigned int hash = 2166136261u;
+
+    for (i = 0;  i < length;  i++)
+    {
+        hash ^= (unsigned char) name[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+
+//========================================================================
+// Find the slot of the specified extension in the hash set of a window
+// Returns the first empty slot it probed if the extension is not present
+//========================================================================
+
+static unsigned int findExtensionSlot(_GLFWwindow* window,
+                                      const char* name, size_t length)
+{
+    unsigned int slot = hashName(name, length) & window->extensionMask;
+
+    // Linear probing, which always terminates as the set is at most half full
+    while (window->extensionSlots[slot])
+    {
+        const char* entry = window->extensionNames +
+                            window->extensionSlots[slot] - 1;
+
+        if (strncmp(entry, name, length) == 0 && entry[length] == '\0')
+            break;
+
+        slot = (slot + 1) & window->extensionMask;
+    }
+
+    return slot;
+}
+
+
+//========================================================================
+// Build the extension hash set of the current context
+// The GL and platform extension strings are collected into one list of
+// names, which is then split in place and hashed
+//========================================================================
+
+static GLboolean initExtensionSet(_GLFWwindow* window)
+{
+    char* name;
+    unsigned int count = 0, size = 1;
+
+    if (window->glMajor < 3)
+    {
+        _glfwAddExtensionString(window,
+                                (const char*) glGetString(GL_EXTENSIONS));
+    }
+    else
+    {
+        GLint i, extensionCount;
+
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+        for (i = 0;  i < extensionCount;  i++)
+        {
+            _glfwAddExtensionString(window,
+                                    (const char*) window->GetStringi(GL_EXTENSIONS, i));
+        }
+    }
+
+    // Additional platform specific extensions (e.g. WGL)
+    _glfwPlatformAddExtensions(window);
+
+    if (!window->extensionNames)
+        _glfwAddExtensionString(window, "");
+
+    if (!window->extensionNames)
+        return GL_FALSE;
+
+    // Split the list into NUL terminated names
+    for (name = window->extensionNames;  *name;  name++)
+    {
+        if (*name == ' ')
+            *name = '\0';
+        else if (name == window->extensionNames || *(name - 1) == '\0')
+            count++;
+    }
+
+    // Keep the set at most half full so that probe sequences stay short
+    while (size < count * 2 + 1)
+        size *= 2;
+
+    window->extensionSlots = (unsigned int*) calloc(size, sizeof(unsigned int));
+    if (!window->extensionSlots)
+    {
+        free(window->extensionNames);
+        window->extensionNames = NULL;
+        window->extensionLength = 0;
+
+        _glfwSetError(GLFW_OUT_OF_MEMORY,
+                      "glfwExtensionSupported: Failed to allocate extension set");
+        return GL_FALSE;
+    }
+
+    window->extensionMask = size - 1;
+
+    name = window->extensionNames;
+    while (name < window->extensionNames + window->extensionLength)
+    {
+        const size_t length = strlen(name);
+
+        if (length)
+        {
+            const unsigned int slot = findExtensionSlot(window, name, length);
+            window->extensionSlots[slot] = name - window->extensionNames + 1;
+        }
+
+        name += length + 1;
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Check whether the specified window supports the specified extension
+//========================================================================
+
+static GLboolean isExtensionSupported(_GLFWwindow* window, const char* extension)
+{
+    size_t length;
+
+    // Extension names should not have spaces
+    if (strchr(extension, ' ') || *extension == '\0')
+        return GL_FALSE;
+
+    length = strlen(extension);
+
+    return window->extensionSlots[findExtensionSlot(window, extension, length)] != 0;
+}
+
+
+#if !defined(_GLFW_WIN32_WGL)
+
+//========================================================================
+// Lock for the entry point cache, which is shared by all threads
+//========================================================================
+
+static pthread_mutex_t procCacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+
+//========================================================================
+// Find the slot of the specified entry point in the cache
+// Returns the first empty slot it probed if the name is not present
+//========================================================================
+
+static unsigned int findProcSlot(const char* procname)
+{
+    unsigned int slot = hashName(procname, strlen(procname)) &
+                        _glfwLibrary.procCache.mask;
+
+    while (_glfwLibrary.procCache.names[slot])
+    {
+        if (strcmp(_glfwLibrary.procCache.names[slot], procname) == 0)
+            break;
+
+        slot = (slot + 1) & _glfwLibrary.procCache.mask;
+    }
+
+    return slot;
+}
+
+
+//========================================================================
+// Make room for one more entry in the entry point cache
+// The cache is kept at most half full so that probe sequences stay short
+//========================================================================
+
+static GLboolean growProcCache(void)
+{
+    unsigned int i, size;
+    char** oldNames = _glfwLibrary.procCache.names;
+    void** oldProcs = _glfwLibrary.procCache.procs;
+    const unsigned int oldSize = oldNames ? _glfwLibrary.procCache.mask + 1 : 0;
+
+    if ((_glfwLibrary.procCache.count + 1) * 2 <= oldSize)
+        return GL_TRUE;
+
+    // Start large enough for a complete core profile loader
+    size = oldSize ? oldSize * 2 : 2048;
+
+    _glfwLibrary.procCache.names = (char**) calloc(size, sizeof(char*));
+    _glfwLibrary.procCache.procs = (void**) calloc(size, sizeof(void*));
+    if (!_glfwLibrary.procCache.names || !_glfwLibrary.procCache.procs)
+    {
+        free(_glfwLibrary.procCache.names);
+        free(_glfwLibrary.procCache.procs);
+        _glfwLibrary.procCache.names = oldNames;
+        _glfwLibrary.procCache.procs = oldProcs;
+        return GL_FALSE;
+    }
+
+    _glfwLibrary.procCache.mask = size - 1;
+
+    for (i = 0;  i < oldSize;  i++)
+    {
+        if (oldNames[i])
+        {
+            const unsigned int slot = findProcSlot(oldNames[i]);
+            _glfwLibrary.procCache.names[slot] = oldNames[i];
+            _glfwLibrary.procCache.procs[slot] = oldProcs[i];
+        }
+    }
+
+    free(oldNames);
+    free(oldProcs);
+    return GL_TRUE;
+}
+
+#endif /*_GLFW_WIN32_WGL*/
+
+
+//========================================================================
+// Get the function pointer to an OpenGL function, using the cache where
+// entry points do not depend on the current context
+//========================================================================
+
+static void* getProcAddress(const char* procname)
+{
+#if defined(_GLFW_WIN32_WGL)
+    // Entry points returned by wglGetProcAddress are only valid for
+    // contexts with the same pixel format, so they cannot be shared
+    return _glfwPlatformGetProcAddress(procname);
+#else
+    unsigned int slot;
+    char* name;
+    void* proc;
+
+    pthread_mutex_lock(&procCacheLock);
+
+    if (_glfwLibrary.procCache.names)
+    {
+        slot = findProcSlot(procname);
+        if (_glfwLibrary.procCache.names[slot])
+        {
+            proc = _glfwLibrary.procCache.procs[slot];
+            pthread_mutex_unlock(&procCacheLock);
+            return proc;
+        }
+    }
+
+    if (!growProcCache() || !(name = strdup(procname)))
+    {
+        pthread_mutex_unlock(&procCacheLock);
+        return _glfwPlatformGetProcAddress(procname);
+    }
+
+    proc = _glfwPlatformGetProcAddress(procname);
+
+    slot = findProcSlot(procname);
+    _glfwLibrary.procCache.names[slot] = name;
+    _glfwLibrary.procCache.procs[slot] = proc;
+    _glfwLibrary.procCache.count++;
+
+    pthread_mutex_unlock(&procCacheLock);
+    return proc;
+#endif
+}
+
 
 //========================================================================
 // Parses the OpenGL version string and extracts the version number
@@ -88,6 +556,136 @@ static void parseGLVersion(int* major, int* minor, int* rev)
 //////                       GLFW internal API                      //////
 //////////////////////////////////////////////////////////////////////////
 
+//========================================================================
+// Store the attributes of the specified framebuffer configurations as
+// columns of count entries, which is the layout they are scored in
+// Platforms that keep their configurations around should keep the columns
+// as well, as building them costs more than scoring them
+// Returns the columns, to be freed by the caller, or NULL on failure
+//========================================================================
+
+int* _glfwTransposeFBConfigs(const _GLFWfbconfig* configs, unsigned int count)
+{
+    unsigned int i;
+    int* columns;
+
+    columns = (int*) malloc(sizeof(int) * count * _GLFW_FBCONFIG_ATTRIBS);
+    if (!columns)
+    {
+        _glfwSetError(GLFW_OUT_OF_MEMORY,
+                      "Failed to allocate framebuffer configuration columns");
+        return NULL;
+    }
+
+    for (i = 0;  i < count;  i++)
+    {
+        const _GLFWfbconfig* c = configs + i;
+
+        columns[count * ATTRIB_RED + i] = c->redBits;
+        columns[count * ATTRIB_GREEN + i] = c->greenBits;
+        columns[count * ATTRIB_BLUE + i] = c->blueBits;
+        columns[count * ATTRIB_ALPHA + i] = c->alphaBits;
+        columns[count * ATTRIB_DEPTH + i] = c->depthBits;
+        columns[count * ATTRIB_STENCIL + i] = c->stencilBits;
+        columns[count * ATTRIB_ACCUM_RED + i] = c->accumRedBits;
+        columns[count * ATTRIB_ACCUM_GREEN + i] = c->accumGreenBits;
+        columns[count * ATTRIB_ACCUM_BLUE + i] = c->accumBlueBits;
+        columns[count * ATTRIB_ACCUM_ALPHA + i] = c->accumAlphaBits;
+        columns[count * ATTRIB_AUX_BUFFERS + i] = c->auxBuffers;
+        columns[count * ATTRIB_STEREO + i] = c->stereo;
+        columns[count * ATTRIB_SAMPLES + i] = c->samples;
+    }
+
+    return columns;
+}
+
+
+//========================================================================
+// Rank the framebuffer configurations in the specified columns (as
+// returned by _glfwTransposeFBConfigs) by how closely they match the
+// desired one, best first
+// Configurations that violate a hard constraint are left out
+// Returns the number of ranked configurations
+//========================================================================
+
+unsigned int _glfwRankFBConfigs(const _GLFWfbconfig* desired,
+                                const int* columns,
+                                unsigned int count,
+                                unsigned int* ranking)
+{
+    unsigned int i, ranked = 0;
+    unsigned int* scores;
+    unsigned int* scratch;
+    unsigned int* sorted;
+    int column, shift;
+
+    if (!count)
+        return 0;
+
+    scores = (unsigned int*) malloc(sizeof(unsigned int) * count *
+                                    (_GLFW_FBCONFIG_SCORES + 1));
+    if (!scores)
+    {
+        _glfwSetError(GLFW_OUT_OF_MEMORY,
+                      "Failed to allocate framebuffer configuration scores");
+        return 0;
+    }
+
+    scratch = scores + count * _GLFW_FBCONFIG_SCORES;
+
+    scoreFBConfigs(desired, columns, count, scores);
+
+    // Disqualified candidates are dropped before sorting
+    for (i = 0;  i < count;  i++)
+    {
+        if (scores[count * SCORE_MISSING + i] < UINT_MAX / 2)
+            ranking[ranked++] = i;
+    }
+
+    if (!ranked)
+    {
+        free(scores);
+        return 0;
+    }
+
+    // Least number of missing buffers is the most important heuristic,
+    // then color buffer size match and lastly size match for other buffers
+    // This is a stable radix sort on the score columns, least significant
+    // first, so equally good candidates keep their original order
+    sorted = ranking;
+
+    for (column = _GLFW_FBCONFIG_SCORES - 1;  column >= 0;  column--)
+    {
+        unsigned int highest = 0;
+
+        // Scores are small, so most of their high bytes are zero everywhere
+        for (i = 0;  i < ranked;  i++)
+        {
+            if (scores[count * column + sorted[i]] > highest)
+                highest = scores[count * column + sorted[i]];
+        }
+
+        for (shift = 0;  shift < 32 && (highest >> shift);  shift += 8)
+        {
+            if (sortByScoreByte(scores + count * column, sorted, ranked,
+                                shift, scratch))
+            {
+                unsigned int* temp = sorted;
+                sorted = scratch;
+                scratch = temp;
+            }
+        }
+    }
+
+    if (sorted != ranking)
+        memcpy(ranking, sorted, sizeof(unsigned int) * ranked);
+
+    free(scores);
+
+    return ranked;
+}
+
+
 //========================================================================
 // Return the available framebuffer config closest to the desired values
 // This is based on the manual GLX Visual selection from 2.6
@@ -457,6 +1055,59 @@ int _glfwStringInExtensionString(const char* string,
 }
 
 
+//========================================================================
+// Append a space separated list of extension names to the extension list
+// of the specified window
+//========================================================================
+
+void _glfwAddExtensionString(_GLFWwindow* window, const char* extensions)
+{
+    char* names;
+    size_t length;
+
+    if (!extensions)
+        return;
+
+    length = strlen(extensions);
+
+    names = (char*) realloc(window->extensionNames,
+                            window->extensionLength + length + 2);
+    if (!names)
+    {
+        _glfwSetError(GLFW_OUT_OF_MEMORY,
+                      "glfwExtensionSupported: Failed to allocate extension list");
+        return;
+    }
+
+    names[window->extensionLength] = ' ';
+    memcpy(names + window->extensionLength + 1, extensions, length + 1);
+
+    window->extensionNames = names;
+    window->extensionLength += length + 1;
+}
+
+
+//========================================================================
+// Free the entry point cache, as the entry points it holds may become
+// invalid once the OpenGL library is unloaded
+//========================================================================
+
+void _glfwFreeProcCache(void)
+{
+    unsigned int i;
+
+    if (_glfwLibrary.procCache.names)
+    {
+        for (i = 0;  i <= _glfwLibrary.procCache.mask;  i++)
+            free(_glfwLibrary.procCache.names[i]);
+    }
+
+    free(_glfwLibrary.procCache.names);
+    free(_glfwLibrary.procCache.procs);
+    memset(&_glfwLibrary.procCache, 0, sizeof(_glfwLibrary.procCache));
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                        GLFW public API                       //////
 //////////////////////////////////////////////////////////////////////////
@@ -475,11 +1126,15 @@ GLFWAPI void glfwMakeContextCurrent(GLFWwindow handle)
         return;
     }
 
-    if (_glfwLibrary.currentWindow == window)
+    // Making the context current again is not free with every driver, so
+    // only actual switches reach the platform
+    if (_glfwCurrentWindow == window)
         return;
 
     _glfwPlatformMakeContextCurrent(window);
-    _glfwLibrary.currentWindow = window;
+    _glfwCurrentWindow = window;
+
+    _GLFW_ATOMIC_INCREMENT(_glfwLibrary.contextSwitches);
 }
 
 
@@ -495,7 +1150,7 @@ GLFWAPI GLFWwindow glfwGetCurrentContext(void)
         return GL_FALSE;
     }
 
-    return _glfwLibrary.currentWindow;
+    return _glfwCurrentWindow;
 }
 
 
@@ -505,19 +1160,25 @@ GLFWAPI GLFWwindow glfwGetCurrentContext(void)
 
 GLFWAPI void glfwSwapBuffers(void)
 {
+    _GLFWwindow* window;
+
     if (!_glfwInitialized)
     {
         _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
         return;
     }
 
-    if (!_glfwLibrary.currentWindow)
+    if (!_glfwCurrentWindow)
     {
         _glfwSetError(GLFW_NO_CURRENT_WINDOW, NULL);
         return;
     }
 
     _glfwPlatformSwapBuffers();
+
+    window = _glfwCurrentWindow;
+    window->swapCount++;
+    window->swapTime = _glfwPlatformGetTime();
 }
 
 
@@ -533,7 +1194,7 @@ GLFWAPI void glfwSwapInterval(int interval)
         return;
     }
 
-    if (!_glfwLibrary.currentWindow)
+    if (!_glfwCurrentWindow)
     {
         _glfwSetError(GLFW_NO_CURRENT_WINDOW, NULL);
         return;
@@ -544,16 +1205,13 @@ GLFWAPI void glfwSwapInterval(int interval)
 
 
 //========================================================================
-// Check if an OpenGL extension is available at runtime
+// Retrieve statistics about the last completed buffer swap of the current
+// context
 //========================================================================
 
-GLFWAPI int glfwExtensionSupported(const char* extension)
+GLFWAPI int glfwGetFrameStats(GLFWframestats* stats)
 {
-    const GLubyte* extensions;
     _GLFWwindow* window;
-    GLubyte* where;
-    GLint count;
-    int i;
 
     if (!_glfwInitialized)
     {
@@ -561,50 +1219,103 @@ GLFWAPI int glfwExtensionSupported(const char* extension)
         return GL_FALSE;
     }
 
-    window = _glfwLibrary.currentWindow;
+    window = _glfwCurrentWindow;
     if (!window)
     {
         _glfwSetError(GLFW_NO_CURRENT_WINDOW, NULL);
         return GL_FALSE;
     }
 
-    // Extension names should not have spaces
-    where = (GLubyte*) strchr(extension, ' ');
-    if (where || *extension == '\0')
+    if (!_glfwPlatformGetFrameStats(window, stats))
+    {
+        // Fall back to when glfwSwapBuffers returned, which is an upper
+        // bound of when the frame was handed to the display system
+        stats->time = window->swapTime;
+        stats->msc = 0;
+        stats->sbc = window->swapCount;
+        stats->exact = GL_FALSE;
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Check if an OpenGL extension is available at runtime
+//========================================================================
+
+GLFWAPI int glfwExtensionSupported(const char* extension)
+{
+    _GLFWwindow* window;
+
+    if (!_glfwInitialized)
+    {
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
         return GL_FALSE;
+    }
 
-    if (window->glMajor < 3)
+    window = _glfwCurrentWindow;
+    if (!window)
     {
-        // Check if extension is in the old style OpenGL extensions string
+        _glfwSetError(GLFW_NO_CURRENT_WINDOW, NULL);
+        return GL_FALSE;
+    }
 
-        extensions = glGetString(GL_EXTENSIONS);
-        if (extensions != NULL)
-        {
-            if (_glfwStringInExtensionString(extension, extensions))
-                return GL_TRUE;
-        }
+    if (!window->extensionSlots)
+    {
+        if (!initExtensionSet(window))
+            return GL_FALSE;
     }
-    else
+
+    return isExtensionSupported(window, extension);
+}
+
+
+//========================================================================
+// Check which of the specified OpenGL extensions are available at runtime
+// Bit i % 32 of mask[i / 32] is set if extension i is supported
+//========================================================================
+
+GLFWAPI int glfwExtensionsSupported(const char** extensions, int count,
+                                    unsigned int* mask)
+{
+    int i, supported = 0;
+    _GLFWwindow* window;
+
+    if (!_glfwInitialized)
     {
-        // Check if extension is in the modern OpenGL extensions string list
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
+        return 0;
+    }
 
-        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    window = _glfwCurrentWindow;
+    if (!window)
+    {
+        _glfwSetError(GLFW_NO_CURRENT_WINDOW, NULL);
+        return 0;
+    }
 
-        for (i = 0;  i < count;  i++)
+    if (count <= 0)
+        return 0;
+
+    memset(mask, 0, sizeof(unsigned int) * ((count + 31) / 32));
+
+    if (!window->extensionSlots)
+    {
+        if (!initExtensionSet(window))
+            return 0;
+    }
+
+    for (i = 0;  i < count;  i++)
+    {
+        if (isExtensionSupported(window, extensions[i]))
         {
-             if (strcmp((const char*) window->GetStringi(GL_EXTENSIONS, i),
-                         extension) == 0)
-             {
-                 return GL_TRUE;
-             }
+            mask[i / 32] |= 1u << (i % 32);
+            supported++;
         }
     }
 
-    // Additional platform specific extension checking (e.g. WGL)
-    if (_glfwPlatformExtensionSupported(extension))
-        return GL_TRUE;
-
-    return GL_FALSE;
+    return supported;
 }
 
 
@@ -621,13 +1332,45 @@ GLFWAPI void* glfwGetProcAddress(const char* procname)
         return NULL;
     }
 
-    if (!_glfwLibrary.currentWindow)
+    if (!_glfwCurrentWindow)
     {
         _glfwSetError(GLFW_NO_CURRENT_WINDOW, NULL);
         return NULL;
     }
 
-    return _glfwPlatformGetProcAddress(procname);
+    return getProcAddress(procname);
+}
+
+
+//========================================================================
+// Get the function pointers to the specified OpenGL functions
+// Returns the number of functions that were found
+//========================================================================
+
+GLFWAPI int glfwGetProcAddresses(const char** procnames, void** procs, int count)
+{
+    int i, found = 0;
+
+    if (!_glfwInitialized)
+    {
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
+        return 0;
+    }
+
+    if (!_glfwCurrentWindow)
+    {
+        _glfwSetError(GLFW_NO_CURRENT_WINDOW, NULL);
+        return 0;
+    }
+
+    for (i = 0;  i < count;  i++)
+    {
+        procs[i] = getProcAddress(procnames[i]);
+        if (procs[i])
+            found++;
+    }
+
+    return found;
 }
 
 
@@ -649,7 +1392,7 @@ GLFWAPI void glfwCopyContext(GLFWwindow hsrc, GLFWwindow hdst, unsigned long mas
     src = (_GLFWwindow*) hsrc;
     dst = (_GLFWwindow*) hdst;
 
-    if (_glfwLibrary.currentWindow == dst)
+    if (_glfwCurrentWindow == dst)
     {
         _glfwSetError(GLFW_INVALID_VALUE,
                       "glfwCopyContext: Cannot copy OpenGL state to a current context");
@@ -171,6 +171,7 @@ int _glfwPlatformInit(void)
 #endif
 
     _glfwLibrary.Win32.instance = GetModuleHandle(NULL);
+    _glfwLibrary.Win32.mainThreadID = GetCurrentThreadId();
 
     // Save the original gamma ramp
     _glfwLibrary.originalRampSize = 256;
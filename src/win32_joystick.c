@@ -207,3 +207,17 @@ int _glfwPlatformGetJoystickButtons(int joy, unsigned char* buttons,
 
     return button;
 }
+
+
+//========================================================================
+// Get queued joystick events
+//========================================================================
+
+int _glfwPlatformGetJoystickEvents(int joy, GLFWjoystickevent* events,
+                                   int maxevents)
+{
+    _glfwSetError(GLFW_PLATFORM_ERROR,
+                  "Win32/WGL: Joystick event queueing is not supported");
+    return 0;
+}
+
@@ -54,7 +54,7 @@ void _glfwPlatformMakeContextCurrent(_GLFWwindow* window)
 
 void _glfwPlatformSwapBuffers(void)
 {
-    _GLFWwindow* window = _glfwLibrary.currentWindow;
+    _GLFWwindow* window = _glfwCurrentWindow;
 
     SwapBuffers(window->WGL.DC);
 }
@@ -66,10 +66,33 @@ void _glfwPlatformSwapBuffers(void)
 
 void _glfwPlatformSwapInterval(int interval)
 {
-    _GLFWwindow* window = _glfwLibrary.currentWindow;
+    _GLFWwindow* window = _glfwCurrentWindow;
+
+    // Without adaptive vsync, the closest match is to always synchronize
+    if (interval < 0 && !window->WGL.EXT_swap_control_tear)
+        interval = -interval;
 
     if (window->WGL.EXT_swap_control)
-        window->WGL.SwapIntervalEXT(interval);
+    {
+        if (!window->WGL.SwapIntervalEXT(interval))
+        {
+            _glfwSetError(GLFW_PLATFORM_ERROR,
+                          "Win32/WGL: Failed to set swap interval");
+        }
+
+        window->swapInterval = window->WGL.GetSwapIntervalEXT();
+    }
+}
+
+
+//========================================================================
+// Retrieve statistics about the last completed buffer swap
+//========================================================================
+
+GLboolean _glfwPlatformGetFrameStats(_GLFWwindow* window, GLFWframestats* stats)
+{
+    // There is no WGL extension for querying presentation times
+    return GL_FALSE;
 }
 
 
@@ -81,7 +104,7 @@ int _glfwPlatformExtensionSupported(const char* extension)
 {
     const GLubyte* extensions;
 
-    _GLFWwindow* window = _glfwLibrary.currentWindow;
+    _GLFWwindow* window = _glfwCurrentWindow;
 
     if (window->WGL.GetExtensionsStringEXT != NULL)
     {
@@ -107,6 +130,23 @@ int _glfwPlatformExtensionSupported(const char* extension)
 }
 
 
+//========================================================================
+// Add the WGL extensions to the extension set of the specified window
+//========================================================================
+
+void _glfwPlatformAddExtensions(_GLFWwindow* window)
+{
+    if (window->WGL.GetExtensionsStringEXT != NULL)
+        _glfwAddExtensionString(window, window->WGL.GetExtensionsStringEXT());
+
+    if (window->WGL.GetExtensionsStringARB != NULL)
+    {
+        _glfwAddExtensionString(window,
+                                window->WGL.GetExtensionsStringARB(window->WGL.DC));
+    }
+}
+
+
 //========================================================================
 // Get the function pointer to an OpenGL function
 //========================================================================
@@ -137,11 +137,13 @@ typedef struct _GLFWcontextWGL
 
     // Platform specific extensions (context specific)
     PFNWGLSWAPINTERVALEXTPROC           SwapIntervalEXT;
+    PFNWGLGETSWAPINTERVALEXTPROC        GetSwapIntervalEXT;
     PFNWGLGETPIXELFORMATATTRIBIVARBPROC GetPixelFormatAttribivARB;
     PFNWGLGETEXTENSIONSSTRINGEXTPROC    GetExtensionsStringEXT;
     PFNWGLGETEXTENSIONSSTRINGARBPROC    GetExtensionsStringARB;
     PFNWGLCREATECONTEXTATTRIBSARBPROC   CreateContextAttribsARB;
     GLboolean                           EXT_swap_control;
+    GLboolean                           EXT_swap_control_tear;
     GLboolean                           ARB_multisample;
     GLboolean                           ARB_pixel_format;
     GLboolean                           ARB_create_context;
@@ -178,6 +180,7 @@ typedef struct _GLFWlibraryWin32
     ATOM                      classAtom;    // Window class atom
     HHOOK                     keyboardHook; // Keyboard hook handle
     DWORD                     foregroundLockTimeout;
+    DWORD                     mainThreadID; // Thread that called glfwInit
     char*                     clipboardString;
 
     // Default monitor
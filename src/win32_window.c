@@ -758,6 +758,9 @@ static LRESULT CALLBACK windowProc(HWND hWnd, UINT uMsg,
 {
     _GLFWwindow* window = (_GLFWwindow*) GetWindowLongPtr(hWnd, 0);
 
+    // Message times are in milliseconds
+    _glfwLibrary.eventTime = (double) GetMessageTime() / 1000.0;
+
     switch (uMsg)
     {
         case WM_CREATE:
@@ -1119,6 +1122,7 @@ static void initWGLExtensions(_GLFWwindow* window)
 {
     // This needs to include every function pointer loaded below
     window->WGL.SwapIntervalEXT = NULL;
+    window->WGL.GetSwapIntervalEXT = NULL;
     window->WGL.GetPixelFormatAttribivARB = NULL;
     window->WGL.GetExtensionsStringARB = NULL;
     window->WGL.GetExtensionsStringEXT = NULL;
@@ -1132,6 +1136,7 @@ static void initWGLExtensions(_GLFWwindow* window)
     window->WGL.EXT_create_context_es2_profile = GL_FALSE;
     window->WGL.ARB_create_context_robustness = GL_FALSE;
     window->WGL.EXT_swap_control = GL_FALSE;
+    window->WGL.EXT_swap_control_tear = GL_FALSE;
     window->WGL.ARB_pixel_format = GL_FALSE;
 
     window->WGL.GetExtensionsStringEXT = (PFNWGLGETEXTENSIONSSTRINGEXTPROC)
@@ -1179,9 +1184,24 @@ static void initWGLExtensions(_GLFWwindow* window)
     {
         window->WGL.SwapIntervalEXT = (PFNWGLSWAPINTERVALEXTPROC)
             wglGetProcAddress("wglSwapIntervalEXT");
+        window->WGL.GetSwapIntervalEXT = (PFNWGLGETSWAPINTERVALEXTPROC)
+            wglGetProcAddress("wglGetSwapIntervalEXT");
 
-        if (window->WGL.SwapIntervalEXT)
+        if (window->WGL.SwapIntervalEXT && window->WGL.GetSwapIntervalEXT)
+        {
             window->WGL.EXT_swap_control = GL_TRUE;
+            window->swapControl = GLFW_SWAP_INTERVAL_BIT |
+                                  GLFW_SWAP_IMMEDIATE_BIT;
+        }
+    }
+
+    if (window->WGL.EXT_swap_control)
+    {
+        if (_glfwPlatformExtensionSupported("WGL_EXT_swap_control_tear"))
+        {
+            window->WGL.EXT_swap_control_tear = GL_TRUE;
+            window->swapControl |= GLFW_SWAP_TEAR_BIT;
+        }
     }
 
     if (_glfwPlatformExtensionSupported("WGL_ARB_pixel_format"))
@@ -1393,7 +1413,7 @@ static void destroyWindow(_GLFWwindow* window)
 {
     // This is duplicated from glfwCloseWindow
     // TODO: Stop duplicating code
-    if (window == _glfwLibrary.currentWindow)
+    if (window == _glfwCurrentWindow)
         glfwMakeContextCurrent(NULL);
 
     // This is duplicated from glfwCloseWindow
@@ -1436,6 +1456,13 @@ int _glfwPlatformOpenWindow(_GLFWwindow* window,
 {
     GLboolean recreateContext = GL_FALSE;
 
+    if (wndconfig->mode == GLFW_OFFSCREEN)
+    {
+        _glfwSetError(GLFW_PLATFORM_ERROR,
+                      "Win32/WGL: Offscreen contexts are not supported");
+        return GL_FALSE;
+    }
+
     window->Win32.desiredRefreshRate = wndconfig->refreshRate;
     window->resizable = wndconfig->resizable;
 
@@ -1670,7 +1697,7 @@ void _glfwPlatformRefreshWindowParams(void)
     DEVMODE dm;
     int pixelFormat;
 
-    _GLFWwindow* window = _glfwLibrary.currentWindow;
+    _GLFWwindow* window = _glfwCurrentWindow;
 
     // Obtain a detailed description of current pixel format
     pixelFormat = GetPixelFormat(window->WGL.DC);
@@ -1763,6 +1790,12 @@ void _glfwPlatformRefreshWindowParams(void)
     }
     else
         window->refreshRate = 0;
+
+    // WGL_EXT_swap_control specifies a default interval of one
+    if (window->WGL.EXT_swap_control)
+        window->swapInterval = window->WGL.GetSwapIntervalEXT();
+    else
+        window->swapInterval = 1;
 }
 
 
@@ -1790,6 +1823,8 @@ void _glfwPlatformPollEvents(void)
 
     while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
     {
+        _glfwLibrary.eventCount++;
+
         switch (msg.message)
         {
             case WM_QUIT:
@@ -1863,6 +1898,34 @@ void _glfwPlatformWaitEvents(void)
 }
 
 
+//========================================================================
+// Wait for new window and input events or until the timeout has elapsed
+//========================================================================
+
+void _glfwPlatformWaitEventsTimeout(double timeout)
+{
+    DWORD milliseconds = INFINITE;
+
+    // Timeouts too long to express are treated as infinite
+    if (timeout * 1e3 < (double) INFINITE)
+        milliseconds = (DWORD) (timeout * 1e3);
+
+    MsgWaitForMultipleObjects(0, NULL, FALSE, milliseconds, QS_ALLEVENTS);
+
+    _glfwPlatformPollEvents();
+}
+
+
+//========================================================================
+// Post an empty event to wake up a thread waiting for events
+//========================================================================
+
+void _glfwPlatformPostEmptyEvent(void)
+{
+    PostThreadMessage(_glfwLibrary.Win32.mainThreadID, WM_NULL, 0, 0);
+}
+
+
 //========================================================================
 // Set physical mouse cursor position
 //========================================================================
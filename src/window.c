@@ -266,7 +266,7 @@ GLFWAPI GLFWwindow glfwOpenWindow(int width, int height,
     if (!_glfwIsValidContextConfig(&wndconfig))
         return GL_FALSE;
 
-    if (mode != GLFW_WINDOWED && mode != GLFW_FULLSCREEN)
+    if (mode != GLFW_WINDOWED && mode != GLFW_FULLSCREEN && mode != GLFW_OFFSCREEN)
     {
         _glfwSetError(GLFW_INVALID_ENUM,
                       "glfwOpenWindow: Invalid enum for 'mode' parameter");
@@ -342,6 +342,72 @@ GLFWAPI GLFWwindow glfwOpenWindow(int width, int height,
 }
 
 
+//========================================================================
+// Create offscreen contexts sharing objects with the specified window, for
+// use by other threads
+//========================================================================
+
+GLFWAPI int glfwOpenSharedContexts(GLFWwindow handle, GLFWwindow* contexts, int count)
+{
+    int i;
+    _GLFWhints hints;
+    _GLFWwindow* previous;
+    _GLFWwindow* share = (_GLFWwindow*) handle;
+
+    if (!_glfwInitialized)
+    {
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
+        return GL_FALSE;
+    }
+
+    if (share == NULL || count < 1)
+    {
+        _glfwSetError(GLFW_INVALID_VALUE,
+                      "glfwOpenSharedContexts: Invalid share window or count");
+        return GL_FALSE;
+    }
+
+    // The hints set for the next window are left alone, and each context
+    // gets the same version and profile as the context it shares with
+    hints = _glfwLibrary.hints;
+    previous = _glfwCurrentWindow;
+
+    for (i = 0;  i < count;  i++)
+    {
+        _glfwSetDefaultWindowHints();
+        _glfwLibrary.hints.glMajor      = share->glMajor;
+        _glfwLibrary.hints.glMinor      = share->glMinor;
+        _glfwLibrary.hints.glForward    = share->glForward;
+        _glfwLibrary.hints.glDebug      = share->glDebug;
+        _glfwLibrary.hints.glProfile    = share->glProfile;
+        _glfwLibrary.hints.glRobustness = share->glRobustness;
+
+        // The contexts never render to their own framebuffers, so their
+        // pbuffers only need to exist
+        contexts[i] = glfwOpenWindow(1, 1, GLFW_OFFSCREEN, NULL, share);
+        if (!contexts[i])
+            break;
+    }
+
+    _glfwLibrary.hints = hints;
+
+    if (i < count)
+    {
+        while (i--)
+        {
+            glfwCloseWindow(contexts[i]);
+            contexts[i] = NULL;
+        }
+    }
+
+    // Opening a window makes its context current, so restore the context
+    // that was current before
+    glfwMakeContextCurrent(previous);
+
+    return i == count;
+}
+
+
 //========================================================================
 // Returns GL_TRUE if the specified window handle is an actual window
 //========================================================================
@@ -473,7 +539,7 @@ GLFWAPI void glfwCloseWindow(GLFWwindow handle)
         return;
 
     // Clear the current context if this window's context is current
-    if (window == _glfwLibrary.currentWindow)
+    if (window == _glfwCurrentWindow)
         glfwMakeContextCurrent(NULL);
 
     // Clear the active window pointer if this is the active window
@@ -492,6 +558,9 @@ GLFWAPI void glfwCloseWindow(GLFWwindow handle)
         *prev = window->next;
     }
 
+    free(window->inputQueue);
+    free(window->extensionNames);
+    free(window->extensionSlots);
     free(window);
 }
 
@@ -510,6 +579,10 @@ GLFWAPI void glfwSetWindowTitle(GLFWwindow handle, const char* title)
         return;
     }
 
+    // Offscreen contexts have no window to change
+    if (window->mode == GLFW_OFFSCREEN)
+        return;
+
     _glfwPlatformSetWindowTitle(window, title);
 }
 
@@ -550,7 +623,7 @@ GLFWAPI void glfwSetWindowSize(GLFWwindow handle, int width, int height)
         return;
     }
 
-    if (window->iconified)
+    if (window->iconified || window->mode == GLFW_OFFSCREEN)
     {
         // TODO: Figure out if this is an error
         return;
@@ -607,7 +680,7 @@ GLFWAPI void glfwSetWindowPos(GLFWwindow handle, int xpos, int ypos)
         return;
     }
 
-    if (window->mode == GLFW_FULLSCREEN || window->iconified)
+    if (window->mode != GLFW_WINDOWED || window->iconified)
     {
         // TODO: Figure out if this is an error
         return;
@@ -631,7 +704,7 @@ GLFWAPI void glfwIconifyWindow(GLFWwindow handle)
         return;
     }
 
-    if (window->iconified)
+    if (window->iconified || window->mode == GLFW_OFFSCREEN)
         return;
 
     _glfwPlatformIconifyWindow(window);
@@ -720,6 +793,10 @@ GLFWAPI int glfwGetWindowParam(GLFWwindow handle, int param)
             return window->glMinor;
         case GLFW_OPENGL_REVISION:
             return window->glRevision;
+        case GLFW_SWAP_INTERVAL:
+            return window->swapInterval;
+        case GLFW_SWAP_CONTROL:
+            return window->swapControl;
         case GLFW_OPENGL_FORWARD_COMPAT:
             return window->glForward;
         case GLFW_OPENGL_DEBUG_CONTEXT:
@@ -875,8 +952,13 @@ GLFWAPI void glfwPollEvents(void)
 
     clearScrollOffsets();
 
+    _glfwLibrary.eventCount = 0;
+    _glfwLibrary.joystickSyscalls = 0;
+    _glfwLibrary.contextSwitches = 0;
     _glfwPlatformPollEvents();
 
+    _glfwFlushCursorMotion();
+
     closeFlaggedWindows();
 }
 
@@ -895,8 +977,89 @@ GLFWAPI void glfwWaitEvents(void)
 
     clearScrollOffsets();
 
+    _glfwLibrary.eventCount = 0;
+    _glfwLibrary.joystickSyscalls = 0;
+    _glfwLibrary.contextSwitches = 0;
     _glfwPlatformWaitEvents();
 
+    _glfwFlushCursorMotion();
+
     closeFlaggedWindows();
 }
 
+
+//========================================================================
+// Wait for new window and input events or until the timeout has elapsed
+//========================================================================
+
+GLFWAPI void glfwWaitEventsTimeout(double timeout)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    if (timeout != timeout || timeout < 0.0)
+    {
+        _glfwSetError(GLFW_INVALID_VALUE,
+                      "glfwWaitEventsTimeout: Invalid timeout");
+        return;
+    }
+
+    clearScrollOffsets();
+
+    _glfwLibrary.eventCount = 0;
+    _glfwLibrary.joystickSyscalls = 0;
+    _glfwLibrary.contextSwitches = 0;
+    _glfwPlatformWaitEventsTimeout(timeout);
+
+    _glfwFlushCursorMotion();
+
+    closeFlaggedWindows();
+}
+
+
+//========================================================================
+// Wake up the thread waiting for events
+// This may be called from any thread
+//========================================================================
+
+GLFWAPI void glfwPostEmptyEvent(void)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
+        return;
+    }
+
+    _glfwPlatformPostEmptyEvent();
+}
+
+
+//========================================================================
+// Return the value of the specified instrumentation counter
+//========================================================================
+
+GLFWAPI int glfwGetCounter(int counter)
+{
+    if (!_glfwInitialized)
+    {
+        _glfwSetError(GLFW_NOT_INITIALIZED, NULL);
+        return 0;
+    }
+
+    switch (counter)
+    {
+        case GLFW_EVENTS_PROCESSED:
+            return _glfwLibrary.eventCount;
+        case GLFW_JOYSTICK_SYSCALLS:
+            return _glfwLibrary.joystickSyscalls;
+        case GLFW_CONTEXT_SWITCHES:
+            return (int) _glfwLibrary.contextSwitches;
+    }
+
+    _glfwSetError(GLFW_INVALID_ENUM, NULL);
+    return 0;
+}
+
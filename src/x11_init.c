@@ -34,6 +34,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <locale.h>
+#include <fcntl.h>
 
 
 //========================================================================
@@ -252,16 +254,88 @@ static int keyCodeToGLFWKeyCode(int keyCode)
 }
 
 
+#if defined(_GLFW_HAS_XKB)
+
 //========================================================================
-// Update the key code LUT
+// Pack the four characters of an Xkb key name into an integer, so that
+// names can be compared without strcmp
 //========================================================================
 
-static void updateKeyCodeLUT(void)
+#define KEY_NAME(a, b, c, d) \
+    (((unsigned int) (a) << 24) | ((unsigned int) (b) << 16) | \
+     ((unsigned int) (c) << 8) | (unsigned int) (d))
+
+
+//========================================================================
+// Map an Xkb key name to a GLFW key code, using the US keyboard layout
+// Names of the alphanumeric section are decoded directly from their row
+// letter and column number instead of being searched for
+//========================================================================
+
+static int keyNameToGLFWKeyCode(const char* name)
 {
-    int keyCode;
+    // Rows AB to AE, columns 1 to 12
+    static const int rows[4][12] =
+    {
+        { GLFW_KEY_Z, GLFW_KEY_X, GLFW_KEY_C, GLFW_KEY_V, GLFW_KEY_B,
+          GLFW_KEY_N, GLFW_KEY_M, GLFW_KEY_COMMA, GLFW_KEY_PERIOD,
+          GLFW_KEY_SLASH, -1, -1 },
+        { GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D, GLFW_KEY_F, GLFW_KEY_G,
+          GLFW_KEY_H, GLFW_KEY_J, GLFW_KEY_K, GLFW_KEY_L,
+          GLFW_KEY_SEMICOLON, GLFW_KEY_APOSTROPHE, -1 },
+        { GLFW_KEY_Q, GLFW_KEY_W, GLFW_KEY_E, GLFW_KEY_R, GLFW_KEY_T,
+          GLFW_KEY_Y, GLFW_KEY_U, GLFW_KEY_I, GLFW_KEY_O, GLFW_KEY_P,
+          GLFW_KEY_LEFT_BRACKET, GLFW_KEY_RIGHT_BRACKET },
+        { GLFW_KEY_1, GLFW_KEY_2, GLFW_KEY_3, GLFW_KEY_4, GLFW_KEY_5,
+          GLFW_KEY_6, GLFW_KEY_7, GLFW_KEY_8, GLFW_KEY_9, GLFW_KEY_0,
+          GLFW_KEY_MINUS, GLFW_KEY_EQUAL }
+    };
+
+    if (name[0] == 'A' &&
+        name[1] >= 'B' && name[1] <= 'E' &&
+        name[2] >= '0' && name[2] <= '1' &&
+        name[3] >= '0' && name[3] <= '9')
+    {
+        const int column = (name[2] - '0') * 10 + (name[3] - '0');
+
+        if (column >= 1 && column <= 12)
+            return rows[name[1] - 'B'][column - 1];
+
+        return -1;
+    }
+
+    switch (KEY_NAME(name[0], name[1], name[2], name[3]))
+    {
+        case KEY_NAME('T', 'L', 'D', 'E'): return GLFW_KEY_GRAVE_ACCENT;
+        case KEY_NAME('B', 'K', 'S', 'L'): return GLFW_KEY_BACKSLASH;
+        case KEY_NAME('L', 'S', 'G', 'T'): return GLFW_KEY_WORLD_1;
+        default:                           return -1;
+    }
+}
+
+#undef KEY_NAME
+
+#endif /* _GLFW_HAS_XKB */
+
+
+//========================================================================
+// Update the key code LUT for the specified range of key codes
+//========================================================================
+
+void _glfwUpdateKeyCodeLUT(int firstKeyCode, int count)
+{
+    int keyCode, lastKeyCode;
+
+    // Valid key code range is [8,255], according to the XLib manual, and
+    // the LUT covers [0,255]
+    lastKeyCode = firstKeyCode + count - 1;
+    if (lastKeyCode > 255)
+        lastKeyCode = 255;
+    if (firstKeyCode < 0)
+        firstKeyCode = 0;
 
     // Clear the LUT
-    for (keyCode = 0;  keyCode < 256;  keyCode++)
+    for (keyCode = firstKeyCode;  keyCode <= lastKeyCode;  keyCode++)
         _glfwLibrary.X11.keyCodeLUT[keyCode] = -1;
 
 #if defined(_GLFW_HAS_XKB)
@@ -269,91 +343,44 @@ static void updateKeyCodeLUT(void)
     // locations independently of the current keyboard layout
     if (_glfwLibrary.X11.Xkb.available)
     {
-        int i, keyCodeGLFW;
-        char name[XkbKeyNameLength + 1];
         XkbDescPtr descr;
 
-        // Get keyboard description
-        descr = XkbGetKeyboard(_glfwLibrary.X11.display,
-                               XkbAllComponentsMask,
-                               XkbUseCoreKbd);
-
-        // Find the X11 key code -> GLFW key code mapping
-        for (keyCode = descr->min_key_code; keyCode <= descr->max_key_code; ++keyCode)
+        // Get only the key names, not the whole keyboard description
+        descr = XkbGetMap(_glfwLibrary.X11.display, 0, XkbUseCoreKbd);
+        if (descr)
         {
-            // Get the key name
-            for (i = 0;  i < XkbKeyNameLength;  i++)
-                name[i] = descr->names->keys[keyCode].name[i];
-
-            name[XkbKeyNameLength] = 0;
-
-            // Map the key name to a GLFW key code. Note: We only map printable
-            // keys here, and we use the US keyboard layout. The rest of the
-            // keys (function keys) are mapped using traditional KeySym
-            // translations.
-            if (strcmp(name, "TLDE") == 0) keyCodeGLFW = GLFW_KEY_GRAVE_ACCENT;
-            else if (strcmp(name, "AE01") == 0) keyCodeGLFW = GLFW_KEY_1;
-            else if (strcmp(name, "AE02") == 0) keyCodeGLFW = GLFW_KEY_2;
-            else if (strcmp(name, "AE03") == 0) keyCodeGLFW = GLFW_KEY_3;
-            else if (strcmp(name, "AE04") == 0) keyCodeGLFW = GLFW_KEY_4;
-            else if (strcmp(name, "AE05") == 0) keyCodeGLFW = GLFW_KEY_5;
-            else if (strcmp(name, "AE06") == 0) keyCodeGLFW = GLFW_KEY_6;
-            else if (strcmp(name, "AE07") == 0) keyCodeGLFW = GLFW_KEY_7;
-            else if (strcmp(name, "AE08") == 0) keyCodeGLFW = GLFW_KEY_8;
-            else if (strcmp(name, "AE09") == 0) keyCodeGLFW = GLFW_KEY_9;
-            else if (strcmp(name, "AE10") == 0) keyCodeGLFW = GLFW_KEY_0;
-            else if (strcmp(name, "AE11") == 0) keyCodeGLFW = GLFW_KEY_MINUS;
-            else if (strcmp(name, "AE12") == 0) keyCodeGLFW = GLFW_KEY_EQUAL;
-            else if (strcmp(name, "AD01") == 0) keyCodeGLFW = GLFW_KEY_Q;
-            else if (strcmp(name, "AD02") == 0) keyCodeGLFW = GLFW_KEY_W;
-            else if (strcmp(name, "AD03") == 0) keyCodeGLFW = GLFW_KEY_E;
-            else if (strcmp(name, "AD04") == 0) keyCodeGLFW = GLFW_KEY_R;
-            else if (strcmp(name, "AD05") == 0) keyCodeGLFW = GLFW_KEY_T;
-            else if (strcmp(name, "AD06") == 0) keyCodeGLFW = GLFW_KEY_Y;
-            else if (strcmp(name, "AD07") == 0) keyCodeGLFW = GLFW_KEY_U;
-            else if (strcmp(name, "AD08") == 0) keyCodeGLFW = GLFW_KEY_I;
-            else if (strcmp(name, "AD09") == 0) keyCodeGLFW = GLFW_KEY_O;
-            else if (strcmp(name, "AD10") == 0) keyCodeGLFW = GLFW_KEY_P;
-            else if (strcmp(name, "AD11") == 0) keyCodeGLFW = GLFW_KEY_LEFT_BRACKET;
-            else if (strcmp(name, "AD12") == 0) keyCodeGLFW = GLFW_KEY_RIGHT_BRACKET;
-            else if (strcmp(name, "AC01") == 0) keyCodeGLFW = GLFW_KEY_A;
-            else if (strcmp(name, "AC02") == 0) keyCodeGLFW = GLFW_KEY_S;
-            else if (strcmp(name, "AC03") == 0) keyCodeGLFW = GLFW_KEY_D;
-            else if (strcmp(name, "AC04") == 0) keyCodeGLFW = GLFW_KEY_F;
-            else if (strcmp(name, "AC05") == 0) keyCodeGLFW = GLFW_KEY_G;
-            else if (strcmp(name, "AC06") == 0) keyCodeGLFW = GLFW_KEY_H;
-            else if (strcmp(name, "AC07") == 0) keyCodeGLFW = GLFW_KEY_J;
-            else if (strcmp(name, "AC08") == 0) keyCodeGLFW = GLFW_KEY_K;
-            else if (strcmp(name, "AC09") == 0) keyCodeGLFW = GLFW_KEY_L;
-            else if (strcmp(name, "AC10") == 0) keyCodeGLFW = GLFW_KEY_SEMICOLON;
-            else if (strcmp(name, "AC11") == 0) keyCodeGLFW = GLFW_KEY_APOSTROPHE;
-            else if (strcmp(name, "AB01") == 0) keyCodeGLFW = GLFW_KEY_Z;
-            else if (strcmp(name, "AB02") == 0) keyCodeGLFW = GLFW_KEY_X;
-            else if (strcmp(name, "AB03") == 0) keyCodeGLFW = GLFW_KEY_C;
-            else if (strcmp(name, "AB04") == 0) keyCodeGLFW = GLFW_KEY_V;
-            else if (strcmp(name, "AB05") == 0) keyCodeGLFW = GLFW_KEY_B;
-            else if (strcmp(name, "AB06") == 0) keyCodeGLFW = GLFW_KEY_N;
-            else if (strcmp(name, "AB07") == 0) keyCodeGLFW = GLFW_KEY_M;
-            else if (strcmp(name, "AB08") == 0) keyCodeGLFW = GLFW_KEY_COMMA;
-            else if (strcmp(name, "AB09") == 0) keyCodeGLFW = GLFW_KEY_PERIOD;
-            else if (strcmp(name, "AB10") == 0) keyCodeGLFW = GLFW_KEY_SLASH;
-            else if (strcmp(name, "BKSL") == 0) keyCodeGLFW = GLFW_KEY_BACKSLASH;
-            else if (strcmp(name, "LSGT") == 0) keyCodeGLFW = GLFW_KEY_WORLD_1;
-            else keyCodeGLFW = -1;
-
-            // Update the key code LUT
-            if ((keyCode >= 0) && (keyCode < 256))
-                _glfwLibrary.X11.keyCodeLUT[keyCode] = keyCodeGLFW;
+            if (XkbGetNames(_glfwLibrary.X11.display,
+                            XkbKeyNamesMask,
+                            descr) == Success)
+            {
+                // Map the key names to GLFW key codes. Note: We only map
+                // printable keys here, and we use the US keyboard layout.
+                // The rest of the keys (function keys) are mapped using
+                // traditional KeySym translations.
+                for (keyCode = firstKeyCode;  keyCode <= lastKeyCode;  keyCode++)
+                {
+                    if (keyCode < descr->min_key_code ||
+                        keyCode > descr->max_key_code)
+                    {
+                        continue;
+                    }
+
+                    _glfwLibrary.X11.keyCodeLUT[keyCode] =
+                        keyNameToGLFWKeyCode(descr->names->keys[keyCode].name);
+                }
+
+                XkbFreeNames(descr, XkbKeyNamesMask, True);
+            }
+
+            // Free the keyboard description
+            XkbFreeKeyboard(descr, 0, True);
         }
-
-        // Free the keyboard description
-        XkbFreeKeyboard(descr, 0, True);
     }
 #endif /* _GLFW_HAS_XKB */
 
     // Translate the un-translated key codes using traditional X11 KeySym
     // lookups
-    for (keyCode = 0;  keyCode < 256;  keyCode++)
+    for (keyCode = firstKeyCode;  keyCode <= lastKeyCode;  keyCode++)
     {
         if (_glfwLibrary.X11.keyCodeLUT[keyCode] < 0)
         {
@@ -510,12 +537,72 @@ static void initEWMH(void)
 }
 
 
+//========================================================================
+// Check whether the character type locale is still the default one
+//========================================================================
+
+static GLboolean isDefaultLocale(void)
+{
+    const char* locale = setlocale(LC_CTYPE, NULL);
+
+    return !locale || strcmp(locale, "C") == 0 || strcmp(locale, "POSIX") == 0;
+}
+
+
+//========================================================================
+// Check whether the input method supports the input style we use
+//========================================================================
+
+static GLboolean hasUsableInputMethodStyle(void)
+{
+    unsigned int i;
+    GLboolean found = GL_FALSE;
+    XIMStyles* styles = NULL;
+
+    if (XGetIMValues(_glfwLibrary.X11.im, XNQueryInputStyle, &styles, NULL) != NULL)
+        return GL_FALSE;
+
+    for (i = 0;  i < styles->count_styles;  i++)
+    {
+        if (styles->supported_styles[i] == (XIMPreeditNothing | XIMStatusNothing))
+        {
+            found = GL_TRUE;
+            break;
+        }
+    }
+
+    XFree(styles);
+    return found;
+}
+
+
+//========================================================================
+// Forget the input method and its input contexts when the input method
+// server goes away, as they are destroyed along with it
+//========================================================================
+
+static void inputMethodDestroyCallback(XIM im, XPointer clientData, XPointer callData)
+{
+    _GLFWwindow* window;
+
+    for (window = _glfwLibrary.windowListHead;  window;  window = window->next)
+        window->X11.ic = NULL;
+
+    _glfwLibrary.X11.im = NULL;
+}
+
+
 //========================================================================
 // Initialize X11 display and look for supported X11 extensions
 //========================================================================
 
 static GLboolean initDisplay(void)
 {
+    // Contexts may be made current and used on other threads, and GLX calls
+    // made there go through the same display connection
+    // This must be the first Xlib call, and repeated calls are harmless
+    XInitThreads();
+
     _glfwLibrary.X11.display = XOpenDisplay(NULL);
     if (!_glfwLibrary.X11.display)
     {
@@ -529,6 +616,9 @@ static GLboolean initDisplay(void)
     _glfwLibrary.X11.root = RootWindow(_glfwLibrary.X11.display,
                                        _glfwLibrary.X11.screen);
 
+    // Allocate the context used to map X11 window handles to GLFW windows
+    _glfwLibrary.X11.context = XUniqueContext();
+
     // Check for XF86VidMode extension
 #ifdef _GLFW_HAS_XF86VIDMODE
     _glfwLibrary.X11.VidMode.available =
@@ -556,6 +646,12 @@ static GLboolean initDisplay(void)
                           "X11/GLX: Failed to query RandR version");
             return GL_FALSE;
         }
+
+        // Listen for screen changes on the root window, so that windowed
+        // applications see them as well as fullscreen ones
+        XRRSelectInput(_glfwLibrary.X11.display,
+                       _glfwLibrary.X11.root,
+                       RRScreenChangeNotifyMask);
     }
 #else
     _glfwLibrary.X11.RandR.available = GL_FALSE;
@@ -588,14 +684,83 @@ static GLboolean initDisplay(void)
                           &_glfwLibrary.X11.Xkb.errorBase,
                           &_glfwLibrary.X11.Xkb.majorVersion,
                           &_glfwLibrary.X11.Xkb.minorVersion);
+
+    // Ask the server to not send a release before every repeated press, so
+    // that key releases never need to look ahead in the event queue
+    if (_glfwLibrary.X11.Xkb.available)
+    {
+        Bool supported;
+
+        XkbSetDetectableAutoRepeat(_glfwLibrary.X11.display, True, &supported);
+        _glfwLibrary.X11.Xkb.detectable = supported ? GL_TRUE : GL_FALSE;
+    }
 #else
     _glfwLibrary.X11.Xkb.available = GL_FALSE;
 #endif /* _GLFW_HAS_XKB */
 
-    // Update the key code LUT
-    // FIXME: We should listen to XkbMapNotify events to track changes to
-    // the keyboard mapping.
-    updateKeyCodeLUT();
+    // Check if XInput2 is supported on this display
+#if defined(_GLFW_HAS_XINPUT2)
+    if (XQueryExtension(_glfwLibrary.X11.display,
+                        "XInputExtension",
+                        &_glfwLibrary.X11.XI2.majorOpcode,
+                        &_glfwLibrary.X11.XI2.eventBase,
+                        &_glfwLibrary.X11.XI2.errorBase))
+    {
+        // Raw motion is only delivered during a pointer grab to clients
+        // that have announced support for XInput 2.1 or later
+        _glfwLibrary.X11.XI2.majorVersion = 2;
+        _glfwLibrary.X11.XI2.minorVersion = 1;
+
+        if (XIQueryVersion(_glfwLibrary.X11.display,
+                           &_glfwLibrary.X11.XI2.majorVersion,
+                           &_glfwLibrary.X11.XI2.minorVersion) == Success &&
+            (_glfwLibrary.X11.XI2.majorVersion > 2 ||
+             _glfwLibrary.X11.XI2.minorVersion >= 1))
+        {
+            _glfwLibrary.X11.XI2.available = GL_TRUE;
+        }
+    }
+#else
+    _glfwLibrary.X11.XI2.available = GL_FALSE;
+#endif /* _GLFW_HAS_XINPUT2 */
+
+#if defined(_GLFW_HAS_XKB)
+    // Listen for keyboard mapping changes, as the key code LUT is updated
+    // along with them
+    if (_glfwLibrary.X11.Xkb.available)
+    {
+        XkbSelectEvents(_glfwLibrary.X11.display, XkbUseCoreKbd,
+                        XkbNewKeyboardNotifyMask | XkbMapNotifyMask,
+                        XkbNewKeyboardNotifyMask | XkbMapNotifyMask);
+    }
+#endif /* _GLFW_HAS_XKB */
+
+    // Build the key code LUT
+    _glfwUpdateKeyCodeLUT(0, 256);
+
+    // Open the input method selected by XMODIFIERS (or the built-in one that
+    // handles dead keys and compose sequences), but only keep it if it
+    // supports input contexts that need no preedit or status area
+    // An input method in the C locale cannot commit any non-ASCII text, so
+    // programs that never set a locale keep translating keysyms instead
+    if (XSupportsLocale() && !isDefaultLocale())
+    {
+        XSetLocaleModifiers("");
+        _glfwLibrary.X11.im = XOpenIM(_glfwLibrary.X11.display, 0, NULL, NULL);
+        if (_glfwLibrary.X11.im && !hasUsableInputMethodStyle())
+        {
+            XCloseIM(_glfwLibrary.X11.im);
+            _glfwLibrary.X11.im = NULL;
+        }
+
+        if (_glfwLibrary.X11.im)
+        {
+            XIMCallback callback;
+            callback.callback = (XIMProc) inputMethodDestroyCallback;
+            callback.client_data = NULL;
+            XSetIMValues(_glfwLibrary.X11.im, XNDestroyCallback, &callback, NULL);
+        }
+    }
 
     // Find or create selection property atom
     _glfwLibrary.X11.selection.property =
@@ -709,6 +874,54 @@ static Cursor createNULLCursor(void)
 }
 
 
+//========================================================================
+// Create the self-pipe used to wake up the event loop from other threads
+//========================================================================
+
+static GLboolean initEmptyEventPipe(void)
+{
+    int i;
+
+    if (pipe(_glfwLibrary.X11.emptyEventPipe) != 0)
+    {
+        _glfwLibrary.X11.emptyEventPipe[0] = -1;
+        _glfwLibrary.X11.emptyEventPipe[1] = -1;
+
+        _glfwSetError(GLFW_PLATFORM_ERROR,
+                      "X11/GLX: Failed to create empty event pipe");
+        return GL_FALSE;
+    }
+
+    for (i = 0;  i < 2;  i++)
+    {
+        const int fd = _glfwLibrary.X11.emptyEventPipe[i];
+
+        // Neither end may block, as the read end is drained until empty
+        // and the write end may be written to while the pipe is full
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Close both ends of the empty event pipe, if open
+//========================================================================
+
+static void terminateEmptyEventPipe(void)
+{
+    if (_glfwLibrary.X11.emptyEventPipe[0] >= 0)
+    {
+        close(_glfwLibrary.X11.emptyEventPipe[0]);
+        close(_glfwLibrary.X11.emptyEventPipe[1]);
+        _glfwLibrary.X11.emptyEventPipe[0] = -1;
+        _glfwLibrary.X11.emptyEventPipe[1] = -1;
+    }
+}
+
+
 //========================================================================
 // Terminate X11 display
 //========================================================================
@@ -718,6 +931,12 @@ static void terminateDisplay(void)
     if (_glfwLibrary.originalRampSize)
         _glfwPlatformSetGammaRamp(&_glfwLibrary.originalRamp);
 
+    if (_glfwLibrary.X11.im)
+    {
+        XCloseIM(_glfwLibrary.X11.im);
+        _glfwLibrary.X11.im = NULL;
+    }
+
     if (_glfwLibrary.X11.display)
     {
         XCloseDisplay(_glfwLibrary.X11.display);
@@ -736,23 +955,38 @@ static void terminateDisplay(void)
 
 int _glfwPlatformInit(void)
 {
+    if (!initEmptyEventPipe())
+        return GL_FALSE;
+
     if (!initDisplay())
+    {
+        terminateEmptyEventPipe();
         return GL_FALSE;
+    }
 
     initGammaRamp();
 
     initEWMH();
 
+    if (!_glfwInitKeySym2Unicode())
+    {
+        terminateDisplay();
+        terminateEmptyEventPipe();
+        return GL_FALSE;
+    }
+
     _glfwLibrary.X11.cursor = createNULLCursor();
 
     // Try to load libGL.so if necessary
     initLibraries();
 
-    _glfwInitJoysticks();
-
     // Start the timer
+    // This needs to be done before joystick initialization, as joystick
+    // event timestamps are converted to the time base of the timer
     _glfwInitTimer();
 
+    _glfwInitJoysticks();
+
     return GL_TRUE;
 }
 
@@ -771,6 +1005,10 @@ int _glfwPlatformTerminate(void)
 
     terminateDisplay();
 
+    terminateEmptyEventPipe();
+
+    _glfwTerminateKeySym2Unicode();
+
     _glfwTerminateJoysticks();
 
     // Unload libGL.so if necessary
@@ -782,6 +1020,9 @@ int _glfwPlatformTerminate(void)
     }
 #endif
 
+    // Free the GLXFBConfig cache
+    _glfwFreeFBConfigCache();
+
     // Free clipboard memory
     if (_glfwLibrary.X11.selection.string)
         free(_glfwLibrary.X11.selection.string);
@@ -823,7 +1064,9 @@ const char* _glfwPlatformGetVersionString(void)
 #if defined(_POSIX_TIMERS) && defined(_POSIX_MONOTONIC_CLOCK)
         " clock_gettime"
 #endif
-#if defined(_GLFW_USE_LINUX_JOYSTICKS)
+#if defined(_GLFW_USE_LINUX_EVDEV)
+        " Linux-evdev"
+#elif defined(_GLFW_USE_LINUX_JOYSTICKS)
         " Linux-joystick-API"
 #else
         " no-joystick-support"
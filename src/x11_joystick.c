@@ -39,16 +39,42 @@
 
 #ifdef _GLFW_USE_LINUX_JOYSTICKS
 
-//------------------------------------------------------------------------
-// Here are the Linux joystick driver v1.x interface definitions that we
-// use (we do not want to rely on <linux/joystick.h>):
-//------------------------------------------------------------------------
-
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <dirent.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#if defined(_GLFW_USE_LINUX_EVDEV)
+
+// Older kernel headers lack the accessors for the event timestamp
+#if !defined(input_event_sec)
+ #define input_event_sec  time.tv_sec
+ #define input_event_usec time.tv_usec
+#endif
+
+// Number of longs needed to hold the specified number of bits
+#define JS_BITS_TO_LONGS(x) (((x) + 8 * sizeof(long) - 1) / (8 * sizeof(long)))
+
+// Test a bit in an evdev capability bit array
+#define JS_TEST_BIT(bit, array) \
+    ((array[(bit) / (8 * sizeof(long))] >> ((bit) % (8 * sizeof(long)))) & 1)
+
+// Joystick device node names and the largest device number we look for
+#define JS_DEVICE_PREFIX "event"
+#define JS_DEVICE_MAX 255
+
+#else
+
+//------------------------------------------------------------------------
+// Here are the Linux joystick driver v1.x interface definitions that we
+// use (we do not want to rely on <linux/joystick.h>):
+//------------------------------------------------------------------------
 
 // Joystick event types
 #define JS_EVENT_BUTTON     0x01    /* button pressed/released */
@@ -68,6 +94,758 @@ struct js_event {
 #define JSIOCGAXES     _IOR('j', 0x11, char)  /* get number of axes (u8) */
 #define JSIOCGBUTTONS  _IOR('j', 0x12, char)  /* get number of buttons (u8) */
 
+// Joystick device node names and the largest device number we look for
+#define JS_DEVICE_PREFIX "js"
+#define JS_DEVICE_MAX 50
+
+#endif // _GLFW_USE_LINUX_EVDEV
+
+// Maximum number of joystick events read per system call
+#define JS_EVENT_BATCH_SIZE 64
+
+// Number of events each joystick keeps for glfwGetJoystickEvents
+#define JS_EVENT_QUEUE_SIZE 256
+
+// The epoll user data identifying the inotify descriptor, as opposed to
+// the index of a joystick
+#define JS_INOTIFY_ID (GLFW_JOYSTICK_LAST + 1)
+
+// The epoll instance watching all open joystick file descriptors and the
+// inotify instance, or -1 if not available
+static int epollfd = -1;
+
+// The inotify instance watching /dev/input for joystick hotplug, or -1 if
+// not available
+static int inotifyfd = -1;
+
+// The number of times each joystick slot has been closed, which is part of
+// the epoll user data so that events left over from a device that has
+// since been replaced in the same slot can be told apart
+static unsigned int generations[GLFW_JOYSTICK_LAST + 1];
+
+#if !defined(_GLFW_USE_LINUX_EVDEV)
+// The layout given by _glfwOpenJoystickFile to the file it is opening, or
+// -1 while opening devices that can be asked for theirs
+static int fileAxes = -1;
+static int fileButtons = -1;
+#endif
+
+
+//========================================================================
+// Add an event to the event queue of the specified joystick
+// The oldest event is discarded if the queue is full
+//========================================================================
+
+static void queueJoystickEvent(int joy, int type, int number, int value,
+                               float position, double time)
+{
+    GLFWjoystickevent* event;
+
+    if (_glfwJoy[joy].EventCount == JS_EVENT_QUEUE_SIZE)
+    {
+        _glfwJoy[joy].EventHead = (_glfwJoy[joy].EventHead + 1) %
+                                  JS_EVENT_QUEUE_SIZE;
+        _glfwJoy[joy].EventCount--;
+    }
+
+    event = _glfwJoy[joy].Events + (_glfwJoy[joy].EventHead +
+                                     _glfwJoy[joy].EventCount) %
+                                    JS_EVENT_QUEUE_SIZE;
+
+    event->type = type;
+    event->number = number;
+    event->value = value;
+    event->position = position;
+    event->time = time;
+
+    _glfwJoy[joy].EventCount++;
+}
+
+
+//========================================================================
+// Set the position of the specified axis
+//========================================================================
+
+static float setJoystickAxis(int joy, int axis, float position)
+{
+    // We need to change the sign for the Y axes, so that
+    // positive = up/forward, according to the GLFW spec.
+    if (axis & 1)
+        position = -position;
+
+    _glfwJoy[joy].Axis[axis] = position;
+    return position;
+}
+
+
+#if defined(_GLFW_USE_LINUX_EVDEV)
+
+//========================================================================
+// Convert an evdev event timestamp to the time base of glfwGetTime
+//========================================================================
+
+static double convertTimestamp(const struct input_event* e)
+{
+    uint64_t raw;
+
+    // The event clock was selected to match the timer at device open
+    if (_glfwLibrary.X11.timer.monotonic)
+    {
+        raw = (uint64_t) e->input_event_sec * (uint64_t) 1000000000 +
+              (uint64_t) e->input_event_usec * (uint64_t) 1000;
+    }
+    else
+    {
+        raw = (uint64_t) e->input_event_sec * (uint64_t) 1000000 +
+              (uint64_t) e->input_event_usec;
+    }
+
+    return (double) (int64_t) (raw - _glfwLibrary.X11.timer.base) *
+        _glfwLibrary.X11.timer.resolution;
+}
+
+
+//========================================================================
+// Returns the normalized position of an evdev axis value
+//========================================================================
+
+static float normalizeAxis(int joy, int code, int value)
+{
+    const int min = _glfwJoy[joy].AbsMin[code];
+    const int max = _glfwJoy[joy].AbsMax[code];
+
+    if (max == min)
+        return 0.0f;
+
+    return (float) (value - min) * 2.0f / (float) (max - min) - 1.0f;
+}
+
+
+//========================================================================
+// Check the capabilities of an evdev device and set up its axes and
+// buttons
+// Returns GL_FALSE if the device is not a joystick
+//========================================================================
+
+static GLboolean initDevice(int joy)
+{
+    unsigned long evBits[JS_BITS_TO_LONGS(EV_CNT)];
+    unsigned long keyBits[JS_BITS_TO_LONGS(KEY_CNT)];
+    unsigned long absBits[JS_BITS_TO_LONGS(ABS_CNT)];
+    const int fd = _glfwJoy[joy].fd;
+    int code;
+    GLboolean joystick = GL_FALSE;
+
+    memset(evBits, 0, sizeof(evBits));
+    memset(keyBits, 0, sizeof(keyBits));
+    memset(absBits, 0, sizeof(absBits));
+
+    if (ioctl(fd, EVIOCGBIT(0, sizeof(evBits)), evBits) < 0 ||
+        ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) < 0 ||
+        ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits) < 0)
+    {
+        return GL_FALSE;
+    }
+
+    // Only accept devices with joystick or gamepad buttons, which leaves
+    // out keyboards, mice, touchpads and tablets
+    for (code = BTN_JOYSTICK;  code < BTN_DIGI;  code++)
+    {
+        if (JS_TEST_BIT(code, keyBits))
+            joystick = GL_TRUE;
+    }
+
+    if (!joystick)
+        return GL_FALSE;
+
+    _glfwJoy[joy].NumButtons = 0;
+
+    for (code = BTN_MISC;  code < KEY_CNT;  code++)
+    {
+        if (JS_TEST_BIT(code, keyBits))
+            _glfwJoy[joy].KeyMap[code - BTN_MISC] = _glfwJoy[joy].NumButtons++;
+        else
+            _glfwJoy[joy].KeyMap[code - BTN_MISC] = -1;
+    }
+
+    _glfwJoy[joy].NumAxes = 0;
+
+    for (code = 0;  code < ABS_CNT;  code++)
+    {
+        struct input_absinfo info;
+
+        _glfwJoy[joy].AbsMap[code] = -1;
+
+        if (!JS_TEST_BIT(code, absBits))
+            continue;
+
+        if (ioctl(fd, EVIOCGABS(code), &info) < 0)
+            continue;
+
+        // Keep the full range of the device instead of assuming 16 bits
+        _glfwJoy[joy].AbsMin[code] = info.minimum;
+        _glfwJoy[joy].AbsMax[code] = info.maximum;
+        _glfwJoy[joy].AbsMap[code] = _glfwJoy[joy].NumAxes++;
+    }
+
+    // Have the kernel timestamp events using the same clock as the timer,
+    // so that event times can be compared with glfwGetTime
+    _glfwJoy[joy].KernelTime = GL_TRUE;
+
+#if defined(EVIOCSCLOCKID) && defined(CLOCK_MONOTONIC)
+    if (_glfwLibrary.X11.timer.monotonic)
+    {
+        int clock = CLOCK_MONOTONIC;
+        if (ioctl(fd, EVIOCSCLOCKID, &clock) < 0)
+            _glfwJoy[joy].KernelTime = GL_FALSE;
+    }
+#else
+    if (_glfwLibrary.X11.timer.monotonic)
+        _glfwJoy[joy].KernelTime = GL_FALSE;
+#endif
+
+    _glfwJoy[joy].Dropped = GL_FALSE;
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Query the current state of all axes and buttons of an evdev device
+//========================================================================
+
+static void syncDevice(int joy)
+{
+    unsigned long keys[JS_BITS_TO_LONGS(KEY_CNT)];
+    int code;
+
+    for (code = 0;  code < ABS_CNT;  code++)
+    {
+        struct input_absinfo info;
+        const int axis = _glfwJoy[joy].AbsMap[code];
+
+        if (axis == -1)
+            continue;
+
+        _glfwLibrary.joystickSyscalls++;
+
+        if (ioctl(_glfwJoy[joy].fd, EVIOCGABS(code), &info) == 0)
+            setJoystickAxis(joy, axis, normalizeAxis(joy, code, info.value));
+    }
+
+    memset(keys, 0, sizeof(keys));
+
+    _glfwLibrary.joystickSyscalls++;
+
+    if (ioctl(_glfwJoy[joy].fd, EVIOCGKEY(sizeof(keys)), keys) < 0)
+        return;
+
+    for (code = BTN_MISC;  code < KEY_CNT;  code++)
+    {
+        const int button = _glfwJoy[joy].KeyMap[code - BTN_MISC];
+
+        if (button != -1)
+        {
+            _glfwJoy[joy].Button[button] =
+                JS_TEST_BIT(code, keys) ? GLFW_PRESS : GLFW_RELEASE;
+        }
+    }
+}
+
+
+//========================================================================
+// Apply a single evdev event to the cached joystick state
+//========================================================================
+
+static void processJoystickEvent(int joy, const struct input_event* e,
+                                 double readTime)
+{
+    const double time = _glfwJoy[joy].KernelTime ? convertTimestamp(e)
+                                                 : readTime;
+
+    if (e->type == EV_SYN)
+    {
+        if (e->code == SYN_DROPPED)
+        {
+            // The kernel buffer overflowed, so ignore everything up to the
+            // next report and then query the state directly
+            _glfwJoy[joy].Dropped = GL_TRUE;
+        }
+        else if (e->code == SYN_REPORT && _glfwJoy[joy].Dropped)
+        {
+            _glfwJoy[joy].Dropped = GL_FALSE;
+            syncDevice(joy);
+        }
+
+        return;
+    }
+
+    if (_glfwJoy[joy].Dropped)
+        return;
+
+    if (e->type == EV_KEY)
+    {
+        int button, action;
+
+        if (e->code < BTN_MISC || e->code >= KEY_CNT)
+            return;
+
+        button = _glfwJoy[joy].KeyMap[e->code - BTN_MISC];
+        if (button == -1)
+            return;
+
+        action = e->value ? GLFW_PRESS : GLFW_RELEASE;
+
+        _glfwJoy[joy].Button[button] = action;
+        queueJoystickEvent(joy, GLFW_BUTTON_EVENT, button, action, 0.f, time);
+    }
+    else if (e->type == EV_ABS)
+    {
+        int axis;
+        float position;
+
+        if (e->code >= ABS_CNT)
+            return;
+
+        axis = _glfwJoy[joy].AbsMap[e->code];
+        if (axis == -1)
+            return;
+
+        position = setJoystickAxis(joy, axis,
+                                   normalizeAxis(joy, e->code, e->value));
+        queueJoystickEvent(joy, GLFW_AXIS_EVENT, axis, e->value,
+                           position, time);
+    }
+}
+
+
+//========================================================================
+// Read all queued events of the specified joystick
+//========================================================================
+
+static void readJoystickEvents(int joy)
+{
+    struct input_event events[JS_EVENT_BATCH_SIZE];
+    ssize_t result;
+    double time;
+    int i, count;
+
+    // Read all queued events (non-blocking), as many per call as will fit
+    for (;;)
+    {
+        _glfwLibrary.joystickSyscalls++;
+
+        result = read(_glfwJoy[joy].fd, events, sizeof(events));
+        if (result <= 0)
+            break;
+
+        time = _glfwPlatformGetTime();
+
+        // The driver only ever returns whole events
+        count = (int) (result / sizeof(struct input_event));
+
+        for (i = 0;  i < count;  i++)
+            processJoystickEvent(joy, events + i, time);
+
+        // A partially filled batch means the queue is now empty, so there
+        // is no need to make another call just to be told so
+        if (count < JS_EVENT_BATCH_SIZE)
+            break;
+    }
+}
+
+#else
+
+//========================================================================
+// Check the joystick driver version and the number of axes and buttons
+// Returns GL_FALSE if the device is not supported
+//========================================================================
+
+static GLboolean initDevice(int joy)
+{
+    const int fd = _glfwJoy[joy].fd;
+    int driver_version = 0x000800;
+    char ret_data;
+
+    // A file opened by _glfwOpenJoystickFile cannot answer the ioctls below,
+    // so it has the layout it was opened with
+    if (fileAxes >= 0)
+    {
+        _glfwJoy[joy].NumAxes = fileAxes;
+        _glfwJoy[joy].NumButtons = fileButtons;
+        return GL_TRUE;
+    }
+
+    // Check that the joystick driver version is 1.0+
+    ioctl(fd, JSIOCGVERSION, &driver_version);
+    if (driver_version < 0x010000)
+    {
+        // It's an old 0.x interface (we don't support it)
+        return GL_FALSE;
+    }
+
+    // Get number of joystick axes
+    ioctl(fd, JSIOCGAXES, &ret_data);
+    _glfwJoy[joy].NumAxes = (int) ret_data;
+
+    // Get number of joystick buttons
+    ioctl(fd, JSIOCGBUTTONS, &ret_data);
+    _glfwJoy[joy].NumButtons = (int) ret_data;
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// Apply a single joystick event to the cached joystick state
+//========================================================================
+
+static void processJoystickEvent(int joy, struct js_event* e, double time)
+{
+    float position;
+
+    // Initial state events update the state but are not queued
+    const GLboolean init = (e->type & JS_EVENT_INIT) ? GL_TRUE : GL_FALSE;
+    e->type &= ~JS_EVENT_INIT;
+
+    // Check event type
+    switch (e->type)
+    {
+        case JS_EVENT_AXIS:
+            if (e->number >= _glfwJoy[joy].NumAxes)
+                break;
+
+            position = setJoystickAxis(joy, e->number,
+                                       (float) e->value / 32767.0f);
+
+            if (!init)
+            {
+                queueJoystickEvent(joy, GLFW_AXIS_EVENT, e->number, e->value,
+                                   position, time);
+            }
+            break;
+
+        case JS_EVENT_BUTTON:
+            if (e->number >= _glfwJoy[joy].NumButtons)
+                break;
+
+            _glfwJoy[joy].Button[e->number] =
+                e->value ? GLFW_PRESS : GLFW_RELEASE;
+
+            if (!init)
+            {
+                queueJoystickEvent(joy, GLFW_BUTTON_EVENT, e->number,
+                                   _glfwJoy[joy].Button[e->number],
+                                   0.f, time);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+//========================================================================
+// Read all queued events of the specified joystick
+//========================================================================
+
+static void readJoystickEvents(int joy)
+{
+    struct js_event events[JS_EVENT_BATCH_SIZE];
+    ssize_t result;
+    double time;
+    int i, count;
+
+    // Read all queued events (non-blocking), as many per call as will fit
+    for (;;)
+    {
+        _glfwLibrary.joystickSyscalls++;
+
+        result = read(_glfwJoy[joy].fd, events, sizeof(events));
+        if (result <= 0)
+            break;
+
+        // The millisecond timestamps of this interface have no defined
+        // relation to any clock, so events are stamped when read
+        time = _glfwPlatformGetTime();
+
+        // The driver only ever returns whole events
+        count = (int) (result / sizeof(struct js_event));
+
+        for (i = 0;  i < count;  i++)
+            processJoystickEvent(joy, events + i, time);
+
+        // A partially filled batch means the queue is now empty, so there
+        // is no need to make another call just to be told so
+        if (count < JS_EVENT_BATCH_SIZE)
+            break;
+    }
+}
+
+
+//========================================================================
+// Pick up the initial state events queued by the driver
+//========================================================================
+
+static void syncDevice(int joy)
+{
+    readJoystickEvents(joy);
+}
+
+#endif // _GLFW_USE_LINUX_EVDEV
+
+
+//========================================================================
+// Returns the joystick opened from the specified device, or -1
+//========================================================================
+
+static int findJoystick(const char* path)
+{
+    int i;
+
+    for (i = 0;  i <= GLFW_JOYSTICK_LAST;  i++)
+    {
+        if (_glfwJoy[i].Present && strcmp(_glfwJoy[i].Path, path) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+
+//========================================================================
+// Open the specified joystick device in the first free slot
+// Returns the joystick index, or -1 if the device could not be used
+//========================================================================
+
+static int openJoystick(const char* path)
+{
+    int joy, fd, n;
+
+    if (findJoystick(path) != -1)
+        return -1;
+
+    for (joy = 0;  joy <= GLFW_JOYSTICK_LAST;  joy++)
+    {
+        if (!_glfwJoy[joy].Present)
+            break;
+    }
+
+    if (joy > GLFW_JOYSTICK_LAST)
+        return -1;
+
+    fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd == -1)
+        return -1;
+
+    _glfwJoy[joy].fd = fd;
+
+    if (!initDevice(joy))
+    {
+        close(fd);
+        return -1;
+    }
+
+    // Allocate memory for joystick state
+    _glfwJoy[joy].Axis = (float*) malloc(sizeof(float) *
+                                         _glfwJoy[joy].NumAxes);
+    if (_glfwJoy[joy].Axis == NULL)
+    {
+        close(fd);
+        return -1;
+    }
+    _glfwJoy[joy].Button = (unsigned char*) malloc(sizeof(char) *
+                                                   _glfwJoy[joy].NumButtons);
+    if (_glfwJoy[joy].Button == NULL)
+    {
+        free(_glfwJoy[joy].Axis);
+        close(fd);
+        return -1;
+    }
+    _glfwJoy[joy].Events = (GLFWjoystickevent*)
+        malloc(sizeof(GLFWjoystickevent) * JS_EVENT_QUEUE_SIZE);
+    if (_glfwJoy[joy].Events == NULL)
+    {
+        free(_glfwJoy[joy].Button);
+        free(_glfwJoy[joy].Axis);
+        close(fd);
+        return -1;
+    }
+
+    // Clear joystick state
+    for (n = 0;  n < _glfwJoy[joy].NumAxes;  n++)
+        _glfwJoy[joy].Axis[n] = 0.0f;
+
+    for (n = 0;  n < _glfwJoy[joy].NumButtons;  n++)
+        _glfwJoy[joy].Button[n] = GLFW_RELEASE;
+
+    _glfwJoy[joy].EventHead = 0;
+    _glfwJoy[joy].EventCount = 0;
+
+    strncpy(_glfwJoy[joy].Path, path, sizeof(_glfwJoy[joy].Path) - 1);
+    _glfwJoy[joy].Path[sizeof(_glfwJoy[joy].Path) - 1] = '\0';
+
+    if (epollfd != -1)
+    {
+        struct epoll_event event;
+
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u64 = ((uint64_t) generations[joy] << 32) | joy;
+
+        epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    // The joystick is supported and connected
+    _glfwJoy[joy].Present = GL_TRUE;
+
+    // Retrieve the initial state of the axes and buttons
+    syncDevice(joy);
+
+    return joy;
+}
+
+
+//========================================================================
+// Close the specified joystick and free its state
+//========================================================================
+
+static void closeJoystick(int joy)
+{
+    if (epollfd != -1)
+        epoll_ctl(epollfd, EPOLL_CTL_DEL, _glfwJoy[joy].fd, NULL);
+
+    close(_glfwJoy[joy].fd);
+    free(_glfwJoy[joy].Axis);
+    free(_glfwJoy[joy].Button);
+    free(_glfwJoy[joy].Events);
+
+    _glfwJoy[joy].Present = GL_FALSE;
+    generations[joy]++;
+}
+
+
+//========================================================================
+// Returns the device number of a joystick device name, or -1
+//========================================================================
+
+static int parseDeviceName(const char* name)
+{
+    char* end;
+    long number;
+
+    const size_t length = strlen(JS_DEVICE_PREFIX);
+
+    if (strncmp(name, JS_DEVICE_PREFIX, length) != 0 ||
+        name[length] < '0' || name[length] > '9')
+    {
+        return -1;
+    }
+
+    number = strtol(name + length, &end, 10);
+    if (*end != '\0' || number > JS_DEVICE_MAX)
+        return -1;
+
+    return (int) number;
+}
+
+
+//========================================================================
+// Open all joystick devices present in the specified directory
+//========================================================================
+
+static void probeDirectory(const char* dirname)
+{
+    DIR* dir;
+    struct dirent* entry;
+    char found[JS_DEVICE_MAX + 1];
+    char path[32];
+    int i;
+
+    // Only look at the devices that actually exist, instead of trying to
+    // open every possible device name
+    dir = opendir(dirname);
+    if (!dir)
+        return;
+
+    memset(found, 0, sizeof(found));
+
+    while ((entry = readdir(dir)))
+    {
+        const int number = parseDeviceName(entry->d_name);
+        if (number != -1)
+            found[number] = GL_TRUE;
+    }
+
+    closedir(dir);
+
+    // Open in device number order so that joystick indices are stable
+    for (i = 0;  i <= JS_DEVICE_MAX;  i++)
+    {
+        if (found[i])
+        {
+            snprintf(path, sizeof(path), "%s/%s%d",
+                     dirname, JS_DEVICE_PREFIX, i);
+            openJoystick(path);
+        }
+    }
+}
+
+
+//========================================================================
+// Process joystick devices appearing and disappearing in /dev/input
+//========================================================================
+
+static void processHotplugEvents(void)
+{
+    char buffer[4096]
+        __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    char path[32];
+    ssize_t size, offset;
+    int joy;
+
+    for (;;)
+    {
+        _glfwLibrary.joystickSyscalls++;
+
+        size = read(inotifyfd, buffer, sizeof(buffer));
+        if (size <= 0)
+            break;
+
+        for (offset = 0;  offset < size;  )
+        {
+            const struct inotify_event* e =
+                (const struct inotify_event*) (buffer + offset);
+
+            offset += sizeof(struct inotify_event) + e->len;
+
+            if (!e->len || parseDeviceName(e->name) == -1)
+                continue;
+
+            snprintf(path, sizeof(path), "/dev/input/%s", e->name);
+
+            if (e->mask & IN_DELETE)
+            {
+                joy = findJoystick(path);
+                if (joy != -1)
+                {
+                    closeJoystick(joy);
+                    _glfwInputJoystick(joy, GLFW_DISCONNECTED);
+                }
+            }
+            else
+            {
+                // The device node may not be accessible when it is first
+                // created, so attribute changes are also retried
+                joy = openJoystick(path);
+                if (joy != -1)
+                    _glfwInputJoystick(joy, GLFW_CONNECTED);
+            }
+        }
+    }
+}
+
 #endif // _GLFW_USE_LINUX_JOYSTICKS
 
 
@@ -81,13 +859,6 @@ struct js_event {
 
 void _glfwInitJoysticks(void)
 {
-#ifdef _GLFW_USE_LINUX_JOYSTICKS
-    int  k, n, fd, joy_count;
-    char* joy_base_name;
-    char joy_dev_name[20];
-    int  driver_version = 0x000800;
-    char ret_data;
-#endif // _GLFW_USE_LINUX_JOYSTICKS
     int  i;
 
     // Start by saying that there are no sticks
@@ -96,85 +867,47 @@ void _glfwInitJoysticks(void)
 
 #ifdef _GLFW_USE_LINUX_JOYSTICKS
 
-    // Try to open joysticks (nonblocking)
-    joy_count = 0;
-    for (k = 0;  k <= 1 && joy_count <= GLFW_JOYSTICK_LAST;  k++)
+    // Watch all joysticks with a single epoll instance, so that event
+    // processing only touches the joysticks that actually have input
+    epollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollfd == -1)
+    {
+        _glfwSetError(GLFW_PLATFORM_ERROR,
+                      "X11/GLX: Failed to create joystick epoll instance");
+    }
+
+    // Watch for joysticks being connected and disconnected
+    inotifyfd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyfd != -1)
     {
-        // Pick joystick base name
-        switch (k)
+        // HACK: Register for IN_ATTRIB as well to get notified when udev
+        //       is done setting up the permissions of the device node
+        if (inotify_add_watch(inotifyfd, "/dev/input",
+                              IN_CREATE | IN_ATTRIB | IN_DELETE) == -1 ||
+            epollfd == -1)
         {
-            case 0:
-                // USB joysticks
-                joy_base_name = "/dev/input/js";
-                break;
-            case 1:
-                // "Legacy" joysticks
-                joy_base_name = "/dev/js";
-                break;
-            default:
-                // This should never happen
-                continue;
+            close(inotifyfd);
+            inotifyfd = -1;
         }
-
-        // Try to open a few of these sticks
-        for (i = 0;  i <= 50 && joy_count <= GLFW_JOYSTICK_LAST;  i++)
+        else
         {
-            sprintf(joy_dev_name, "%s%d", joy_base_name, i);
-            fd = open(joy_dev_name, O_NONBLOCK);
-            if (fd != -1)
-            {
-                // Remember fd
-                _glfwJoy[joy_count].fd = fd;
-
-                // Check that the joystick driver version is 1.0+
-                ioctl(fd, JSIOCGVERSION, &driver_version);
-                if (driver_version < 0x010000)
-                {
-                    // It's an old 0.x interface (we don't support it)
-                    close(fd);
-                    continue;
-                }
-
-                // Get number of joystick axes
-                ioctl(fd, JSIOCGAXES, &ret_data);
-                _glfwJoy[joy_count].NumAxes = (int) ret_data;
-
-                // Get number of joystick buttons
-                ioctl(fd, JSIOCGBUTTONS, &ret_data);
-                _glfwJoy[joy_count].NumButtons = (int) ret_data;
-
-                // Allocate memory for joystick state
-                _glfwJoy[joy_count].Axis =
-                    (float*) malloc(sizeof(float) *
-                                     _glfwJoy[joy_count].NumAxes);
-                if (_glfwJoy[joy_count].Axis == NULL)
-                {
-                    close(fd);
-                    continue;
-                }
-                _glfwJoy[joy_count].Button =
-                    (unsigned char*) malloc(sizeof(char) *
-                                     _glfwJoy[joy_count].NumButtons);
-                if (_glfwJoy[joy_count].Button == NULL)
-                {
-                    free(_glfwJoy[joy_count].Axis);
-                    close(fd);
-                    continue;
-                }
-
-                // Clear joystick state
-                for (n = 0;  n < _glfwJoy[joy_count].NumAxes;  n++)
-                    _glfwJoy[joy_count].Axis[n] = 0.0f;
+            struct epoll_event event;
 
-                for (n = 0;  n < _glfwJoy[joy_count].NumButtons;  n++)
-                    _glfwJoy[joy_count].Button[n] = GLFW_RELEASE;
+            memset(&event, 0, sizeof(event));
+            event.events = EPOLLIN;
+            event.data.u64 = JS_INOTIFY_ID;
 
-                // The joystick is supported and connected
-                _glfwJoy[joy_count].Present = GL_TRUE;
-                joy_count++;
-            }
+            epoll_ctl(epollfd, EPOLL_CTL_ADD, inotifyfd, &event);
         }
     }
+
+    // Open the joysticks already connected, starting with USB joysticks
+    // and then "legacy" joysticks
+    probeDirectory("/dev/input");
+#if !defined(_GLFW_USE_LINUX_EVDEV)
+    probeDirectory("/dev");
+#endif
+
 #endif // _GLFW_USE_LINUX_JOYSTICKS
 }
 
@@ -194,13 +927,19 @@ void _glfwTerminateJoysticks(void)
     for (i = 0;  i <= GLFW_JOYSTICK_LAST;  i++)
     {
         if (_glfwJoy[i].Present)
-        {
-            close(_glfwJoy[i].fd);
-            free(_glfwJoy[i].Axis);
-            free(_glfwJoy[i].Button);
+            closeJoystick(i);
+    }
 
-            _glfwJoy[i].Present = GL_FALSE;
-        }
+    if (inotifyfd != -1)
+    {
+        close(inotifyfd);
+        inotifyfd = -1;
+    }
+
+    if (epollfd != -1)
+    {
+        close(epollfd);
+        epollfd = -1;
     }
 
 #endif // _GLFW_USE_LINUX_JOYSTICKS
@@ -209,54 +948,101 @@ void _glfwTerminateJoysticks(void)
 
 
 //========================================================================
-// Empty joystick event queue
+// Process the events of all joysticks with pending input and any
+// joysticks being connected or disconnected
 //========================================================================
 
-static void pollJoystickEvents(void)
+void _glfwProcessJoystickEvents(void)
 {
 #ifdef _GLFW_USE_LINUX_JOYSTICKS
 
-    struct js_event e;
-    int i;
+    struct epoll_event events[GLFW_JOYSTICK_LAST + 2];
+    int i, count;
 
-    // Get joystick events for all GLFW joysticks
-    for (i = 0;  i <= GLFW_JOYSTICK_LAST;  i++)
+    if (epollfd == -1)
+        return;
+
+    _glfwLibrary.joystickSyscalls++;
+
+    count = epoll_wait(epollfd, events, GLFW_JOYSTICK_LAST + 2, 0);
+    for (i = 0;  i < count;  i++)
     {
-        // Is the stick present?
-        if (_glfwJoy[i].Present)
+        const int joy = (int) (events[i].data.u64 & 0xffffffff);
+        const unsigned int generation =
+            (unsigned int) (events[i].data.u64 >> 32);
+
+        if (joy == JS_INOTIFY_ID)
         {
-            // Read all queued events (non-blocking)
-            while (read(_glfwJoy[i].fd, &e, sizeof(struct js_event)) > 0)
-            {
-                // We don't care if it's an init event or not
-                e.type &= ~JS_EVENT_INIT;
+            processHotplugEvents();
+            continue;
+        }
 
-                // Check event type
-                switch (e.type)
-                {
-                    case JS_EVENT_AXIS:
-                        _glfwJoy[i].Axis[e.number] = (float) e.value / 32767.0f;
-                        // We need to change the sign for the Y axes, so that
-                        // positive = up/forward, according to the GLFW spec.
-                        if (e.number & 1)
-                            _glfwJoy[i].Axis[e.number] = -_glfwJoy[i].Axis[e.number];
-                        break;
-
-                    case JS_EVENT_BUTTON:
-                        _glfwJoy[i].Button[e.number] =
-                            e.value ? GLFW_PRESS : GLFW_RELEASE;
-                        break;
-
-                    default:
-                        break;
-                }
-            }
+        // The joystick may have been closed, and its slot even reused, by
+        // an earlier hotplug event in this batch
+        if (!_glfwJoy[joy].Present || generation != generations[joy])
+            continue;
+
+        if (events[i].events & (EPOLLERR | EPOLLHUP))
+        {
+            // The device is gone
+            closeJoystick(joy);
+            _glfwInputJoystick(joy, GLFW_DISCONNECTED);
+            continue;
         }
+
+        readJoystickEvents(joy);
     }
+
+#endif // _GLFW_USE_LINUX_JOYSTICKS
+}
+
+
+//========================================================================
+// Return a descriptor that becomes readable when any joystick has input or
+// is connected or disconnected, or -1 if there is none
+//========================================================================
+
+int _glfwGetJoystickFD(void)
+{
+#ifdef _GLFW_USE_LINUX_JOYSTICKS
+    return epollfd;
+#else
+    return -1;
 #endif // _GLFW_USE_LINUX_JOYSTICKS
 }
 
 
+//========================================================================
+// Open a file of Linux joystick API events, such as a FIFO, as a joystick
+// with the specified number of axes and buttons
+// This lets the event reading code be tested without any hardware (see
+// the jsfifo test), and is not used by the library itself
+// Returns the index of the joystick, or -1 on failure
+//========================================================================
+
+int _glfwOpenJoystickFile(const char* path, int axes, int buttons)
+{
+#if defined(_GLFW_USE_LINUX_JOYSTICKS) && !defined(_GLFW_USE_LINUX_EVDEV)
+    int joy;
+
+    if (axes < 0 || buttons < 0 || strlen(path) >= sizeof(_glfwJoy[0].Path))
+        return -1;
+
+    fileAxes = axes;
+    fileButtons = buttons;
+
+    joy = openJoystick(path);
+
+    fileAxes = -1;
+    fileButtons = -1;
+
+    return joy;
+#else
+    return -1;
+#endif
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW platform API                      //////
 //////////////////////////////////////////////////////////////////////////
@@ -306,9 +1092,6 @@ int _glfwPlatformGetJoystickPos(int joy, float* pos, int numaxes)
         return 0;
     }
 
-    // Update joystick state
-    pollJoystickEvents();
-
     // Does the joystick support less axes than requested?
     if (_glfwJoy[joy].NumAxes < numaxes)
         numaxes = _glfwJoy[joy].NumAxes;
@@ -336,9 +1119,6 @@ int _glfwPlatformGetJoystickButtons(int joy, unsigned char* buttons,
         return 0;
     }
 
-    // Update joystick state
-    pollJoystickEvents();
-
     // Does the joystick support less buttons than requested?
     if (_glfwJoy[joy].NumButtons < numbuttons)
         numbuttons = _glfwJoy[joy].NumButtons;
@@ -350,3 +1130,43 @@ int _glfwPlatformGetJoystickButtons(int joy, unsigned char* buttons,
     return numbuttons;
 }
 
+
+//========================================================================
+// Get queued joystick events
+//========================================================================
+
+int _glfwPlatformGetJoystickEvents(int joy, GLFWjoystickevent* events,
+                                   int maxevents)
+{
+#ifdef _GLFW_USE_LINUX_JOYSTICKS
+
+    int i;
+
+    if (!_glfwJoy[joy].Present)
+    {
+        // TODO: Figure out if this is an error
+        return 0;
+    }
+
+    if (_glfwJoy[joy].EventCount < maxevents)
+        maxevents = _glfwJoy[joy].EventCount;
+
+    for (i = 0;  i < maxevents;  i++)
+    {
+        events[i] = _glfwJoy[joy].Events[(_glfwJoy[joy].EventHead + i) %
+                                         JS_EVENT_QUEUE_SIZE];
+    }
+
+    _glfwJoy[joy].EventHead = (_glfwJoy[joy].EventHead + maxevents) %
+                              JS_EVENT_QUEUE_SIZE;
+    _glfwJoy[joy].EventCount -= maxevents;
+
+    return maxevents;
+
+#else
+
+    return 0;
+
+#endif // _GLFW_USE_LINUX_JOYSTICKS
+}
+
@@ -30,6 +30,9 @@
 
 #include "internal.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 
 /*
  * Marcus: This code was originally written by Markus G. Kuhn.
@@ -42,9 +45,10 @@
  * (UCS, Unicode) values.
  *
  * The array keysymtab[] contains pairs of X11 keysym values for graphical
- * characters and the corresponding Unicode value. The function
- * _glfwKeySym2Unicode() maps a keysym onto a Unicode value using a binary
- * search, therefore keysymtab[] must remain SORTED by keysym value.
+ * characters and the corresponding Unicode value. At initialization, the
+ * function _glfwInitKeySym2Unicode() builds a two-level page table from
+ * it, which _glfwKeySym2Unicode() then uses to map a keysym onto a Unicode
+ * value in constant time. keysymtab[] should remain SORTED by keysym value.
  *
  * We allow to represent any UCS character in the range U-00000000 to
  * U-00FFFFFF by a keysym value in the range 0x01000000 to 0x01ffffff.
@@ -831,7 +835,6 @@ static struct codepair {
   { 0x20ac, 0x20ac },
   // Numeric keypad with numlock on
   { XK_KP_Space, ' ' },
-  { XK_KP_Equal, '=' },
   { XK_KP_Multiply, '*' },
   { XK_KP_Add, '+' },
   { XK_KP_Separator, ',' },
@@ -847,23 +850,114 @@ static struct codepair {
   { XK_KP_6, 0x0036 },
   { XK_KP_7, 0x0037 },
   { XK_KP_8, 0x0038 },
-  { XK_KP_9, 0x0039 }
+  { XK_KP_9, 0x0039 },
+  { XK_KP_Equal, '=' }
 };
 
 
+//************************************************************************
+//****                KeySym to Unicode page table                    ****
+//************************************************************************
+
+/*
+ * All keysyms in keysymtab[] are below 0x10000, so they are split into a
+ * page number (the high byte) and an index into that page (the low byte).
+ * keysympages[] maps page numbers to pages of keysympagetab[], where page
+ * zero is left empty for all page numbers without any entries. A Unicode
+ * value of zero means there is no mapping, as no entry maps to zero.
+ *
+ * keysympagetab[] is allocated with as many pages as keysymtab[] uses, so
+ * the table can grow without any limit to update here.
+ */
+
+static unsigned short keysympages[256];
+static unsigned short (*keysympagetab)[256] = NULL;
+
+
 //************************************************************************
 //****                  GLFW internal functions                       ****
 //************************************************************************
 
+//========================================================================
+// _glfwInitKeySym2Unicode() - Build the KeySym to Unicode page table
+//========================================================================
+
+int _glfwInitKeySym2Unicode( void )
+{
+    int i, page, pagecount = 1;
+    const int count = sizeof(keysymtab) / sizeof(struct codepair);
+
+    memset( keysympages, 0, sizeof(keysympages) );
+
+    /* Count the pages in use, plus the empty page */
+    for( i = 0;  i < count;  i++ )
+    {
+        if( !keysympages[ keysymtab[i].keysym >> 8 ] )
+        {
+            keysympages[ keysymtab[i].keysym >> 8 ] = 1;
+            pagecount++;
+        }
+    }
+
+    keysympagetab = (unsigned short (*)[256])
+        calloc( pagecount, sizeof(*keysympagetab) );
+    if( !keysympagetab )
+    {
+        _glfwSetError( GLFW_OUT_OF_MEMORY,
+                       "X11/GLX: Failed to allocate keysym page table" );
+        return GL_FALSE;
+    }
+
+    memset( keysympages, 0, sizeof(keysympages) );
+    pagecount = 1;
+
+    for( i = 0;  i < count;  i++ )
+    {
+        page = keysympages[ keysymtab[i].keysym >> 8 ];
+        if( !page )
+        {
+            page = pagecount++;
+            keysympages[ keysymtab[i].keysym >> 8 ] = (unsigned short) page;
+        }
+
+        keysympagetab[ page ][ keysymtab[i].keysym & 0xff ] = keysymtab[i].ucs;
+    }
+
+    return GL_TRUE;
+}
+
+
+//========================================================================
+// _glfwTerminateKeySym2Unicode() - Free the KeySym to Unicode page table
+//========================================================================
+
+void _glfwTerminateKeySym2Unicode( void )
+{
+    free( keysympagetab );
+    keysympagetab = NULL;
+}
+
+
+//========================================================================
+// _glfwGetKeySymTable() - Return the sorted KeySym to Unicode pairs
+// The table is returned as keysym and Unicode value pairs, for checking
+// the page table against
+//========================================================================
+
+const unsigned short* _glfwGetKeySymTable( int* count )
+{
+    *count = sizeof(keysymtab) / sizeof(struct codepair);
+    return &keysymtab[0].keysym;
+}
+
+
 //========================================================================
 // _glfwKeySym2Unicode() - Convert X11 KeySym to Unicode
 //========================================================================
 
 long _glfwKeySym2Unicode( KeySym keysym )
 {
-    int min = 0;
-    int max = sizeof(keysymtab) / sizeof(struct codepair) - 1;
-    int mid;
+    unsigned short ucs;
 
     /* First check for Latin-1 characters (1:1 mapping) */
     if( (keysym >= 0x0020 && keysym <= 0x007e) ||
@@ -875,20 +969,13 @@ long _glfwKeySym2Unicode( KeySym keysym )
     if( (keysym & 0xff000000) == 0x01000000 )
         return keysym & 0x00ffffff;
 
-    /* Binary search in table */
-    while( max >= min )
-    {
-        mid = (min + max) / 2;
-        if( keysymtab[mid].keysym < keysym )
-            min = mid + 1;
-        else if( keysymtab[mid].keysym > keysym )
-            max = mid - 1;
-        else
-        {
-            /* Found it! */
-            return keysymtab[mid].ucs;
-        }
-    }
+    /* Look up the page, then the entry within it */
+    if( keysym > 0xffff )
+        return -1;
+
+    ucs = keysympagetab[ keysympages[ keysym >> 8 ] ][ keysym & 0xff ];
+    if( ucs )
+        return ucs;
 
     /* No matching Unicode value found */
     return -1;
@@ -48,7 +48,7 @@ void _glfwPlatformMakeContextCurrent(_GLFWwindow* window)
     if (window)
     {
         glXMakeCurrent(_glfwLibrary.X11.display,
-                       window->X11.handle,
+                       window->GLX.drawable,
                        window->GLX.context);
     }
     else
@@ -63,7 +63,7 @@ void _glfwPlatformMakeContextCurrent(_GLFWwindow* window)
 void _glfwPlatformSwapBuffers(void)
 {
     glXSwapBuffers(_glfwLibrary.X11.display,
-                   _glfwLibrary.currentWindow->X11.handle);
+                   _glfwCurrentWindow->GLX.drawable);
 }
 
 
@@ -73,16 +73,111 @@ void _glfwPlatformSwapBuffers(void)
 
 void _glfwPlatformSwapInterval(int interval)
 {
-    _GLFWwindow* window = _glfwLibrary.currentWindow;
+    _GLFWwindow* window = _glfwCurrentWindow;
+
+    // Without adaptive vsync, the closest match is to always synchronize
+    if (interval < 0 && !window->GLX.EXT_swap_control_tear)
+        interval = -interval;
 
     if (window->GLX.EXT_swap_control)
     {
         window->GLX.SwapIntervalEXT(_glfwLibrary.X11.display,
-                                    window->X11.handle,
+                                    window->GLX.drawable,
                                     interval);
+
+        window->swapInterval = _glfwGetSwapInterval(window);
     }
     else if (window->GLX.SGI_swap_control)
-        window->GLX.SwapIntervalSGI(interval);
+    {
+        if (interval == 0)
+        {
+            _glfwSetError(GLFW_PLATFORM_ERROR,
+                          "X11/GLX: GLX_SGI_swap_control cannot disable "
+                          "synchronization");
+            return;
+        }
+
+        if (window->GLX.SwapIntervalSGI(interval) != 0)
+        {
+            _glfwSetError(GLFW_PLATFORM_ERROR,
+                          "X11/GLX: Failed to set swap interval");
+            return;
+        }
+
+        window->swapInterval = interval;
+    }
+}
+
+
+//========================================================================
+// Return the swap interval in effect for the specified window
+// Negative values mean late swaps tear, as with GLX_EXT_swap_control_tear
+//========================================================================
+
+int _glfwGetSwapInterval(_GLFWwindow* window)
+{
+    unsigned int interval, tear = 0;
+
+    // Pbuffers are never presented and so never wait for a retrace
+    if (window->mode == GLFW_OFFSCREEN)
+        return 0;
+
+    // Both extensions specify a default interval of one, but only
+    // GLX_EXT_swap_control allows querying the actual value
+    if (!window->GLX.EXT_swap_control)
+        return window->swapInterval ? window->swapInterval : 1;
+
+    glXQueryDrawable(_glfwLibrary.X11.display, window->GLX.drawable,
+                     GLX_SWAP_INTERVAL_EXT, &interval);
+
+    if (window->GLX.EXT_swap_control_tear)
+    {
+        glXQueryDrawable(_glfwLibrary.X11.display, window->GLX.drawable,
+                         GLX_LATE_SWAPS_TEAR_EXT, &tear);
+    }
+
+    return tear ? -(int) interval : (int) interval;
+}
+
+
+//========================================================================
+// Retrieve statistics about the last completed buffer swap
+//========================================================================
+
+GLboolean _glfwPlatformGetFrameStats(_GLFWwindow* window, GLFWframestats* stats)
+{
+    int64_t ust, msc, sbc;
+
+    if (!window->GLX.OML_sync_control)
+        return GL_FALSE;
+
+    // Find the number of completed swaps, then ask for the UST and MSC of
+    // the last of them, which does not block as it has already completed
+    if (!window->GLX.GetSyncValuesOML(_glfwLibrary.X11.display,
+                                      window->GLX.drawable,
+                                      &ust, &msc, &sbc))
+    {
+        return GL_FALSE;
+    }
+
+    if (sbc == 0)
+        return GL_FALSE;
+
+    if (!window->GLX.WaitForSbcOML(_glfwLibrary.X11.display,
+                                   window->GLX.drawable,
+                                   sbc, &ust, &msc, &sbc))
+    {
+        return GL_FALSE;
+    }
+
+    // UST is CLOCK_MONOTONIC in microseconds on Linux
+    if (!_glfwConvertMonotonicTime(ust, &stats->time))
+        return GL_FALSE;
+
+    stats->msc = (unsigned int) msc;
+    stats->sbc = (unsigned int) sbc;
+    stats->exact = GL_TRUE;
+    return GL_TRUE;
 }
 
 
@@ -107,6 +202,18 @@ int _glfwPlatformExtensionSupported(const char* extension)
 }
 
 
+//========================================================================
+// Add the GLX extensions to the extension set of the specified window
+//========================================================================
+
+void _glfwPlatformAddExtensions(_GLFWwindow* window)
+{
+    _glfwAddExtensionString(window,
+                            glXQueryExtensionsString(_glfwLibrary.X11.display,
+                                                     _glfwLibrary.X11.screen));
+}
+
+
 //========================================================================
 // Get the function pointer to an OpenGL function
 //========================================================================
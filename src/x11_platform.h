@@ -37,6 +37,7 @@
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
 #include <X11/Xatom.h>
+#include <X11/Xresource.h>
 
 #define GLX_GLXEXT_LEGACY
 #include <GL/glx.h>
@@ -65,6 +66,16 @@
  #include <X11/XKBlib.h>
 #endif
 
+// XInput2 provides raw pointer motion for captured cursors
+#if defined(_GLFW_HAS_XINPUT2)
+ #include <X11/extensions/XInput2.h>
+#endif
+
+// The evdev interface provides timestamped, full resolution joystick input
+#if defined(_GLFW_USE_LINUX_EVDEV)
+ #include <linux/input.h>
+#endif
+
 // We support four different ways for getting addresses for GL/GLX
 // extension functions: glXGetProcAddress, glXGetProcAddressARB,
 // glXGetProcAddressEXT, and dlsym
@@ -81,6 +92,11 @@
  #error "No OpenGL entry point retrieval mechanism was enabled"
 #endif
 
+// This is not yet in our copy of glxext.h
+#ifndef GLX_LATE_SWAPS_TEAR_EXT
+ #define GLX_LATE_SWAPS_TEAR_EXT 0x20F3
+#endif
+
 #define _GLFW_PLATFORM_WINDOW_STATE  _GLFWwindowX11 X11
 #define _GLFW_PLATFORM_CONTEXT_STATE _GLFWcontextGLX GLX
 #define _GLFW_PLATFORM_LIBRARY_WINDOW_STATE _GLFWlibraryX11 X11
@@ -116,6 +132,8 @@ typedef struct _GLFWcontextGLX
     GLXFBConfigID fbconfigID;        // ID of selected GLXFBConfig
     GLXContext    context;           // OpenGL rendering context
     XVisualInfo*  visual;            // Visual for selected GLXFBConfig
+    GLXPbuffer    pbuffer;           // Pbuffer of an offscreen context
+    GLXDrawable   drawable;          // Window or pbuffer to render to
 
     // GLX extensions
     PFNGLXSWAPINTERVALSGIPROC             SwapIntervalSGI;
@@ -125,14 +143,18 @@ typedef struct _GLFWcontextGLX
     PFNGLXCREATECONTEXTWITHCONFIGSGIXPROC CreateContextWithConfigSGIX;
     PFNGLXGETVISUALFROMFBCONFIGSGIXPROC   GetVisualFromFBConfigSGIX;
     PFNGLXCREATECONTEXTATTRIBSARBPROC     CreateContextAttribsARB;
+    PFNGLXGETSYNCVALUESOMLPROC            GetSyncValuesOML;
+    PFNGLXWAITFORSBCOMLPROC               WaitForSbcOML;
     GLboolean   SGIX_fbconfig;
     GLboolean   SGI_swap_control;
     GLboolean   EXT_swap_control;
+    GLboolean   EXT_swap_control_tear;
     GLboolean   ARB_multisample;
     GLboolean   ARB_create_context;
     GLboolean   ARB_create_context_profile;
     GLboolean   ARB_create_context_robustness;
     GLboolean   EXT_create_context_es2_profile;
+    GLboolean   OML_sync_control;
 
 } _GLFWcontextGLX;
 
@@ -145,6 +167,7 @@ typedef struct _GLFWwindowX11
     // Platform specific window resources
     Colormap      colormap;          // Window colormap
     Window        handle;            // Window handle
+    XIC           ic;                // Input context, if any
 
     // Various platform specific internal variables
     GLboolean     overrideRedirect; // True if window is OverrideRedirect
@@ -153,6 +176,8 @@ typedef struct _GLFWwindowX11
     GLboolean     cursorHidden;     // True if cursor is currently hidden
     GLboolean     cursorCentered;   // True if cursor was moved since last poll
     int           cursorPosX, cursorPosY;
+    double        rawMotionX, rawMotionY; // Raw motion not yet reported
+    Time          keyPressTimes[256]; // Time of the last press of each key code
 
 } _GLFWwindowX11;
 
@@ -166,6 +191,10 @@ typedef struct _GLFWlibraryX11
     int             screen;
     Window          root;
     Cursor          cursor;   // Invisible cursor for hidden cursor
+    XContext        context;  // Context for mapping handles to GLFW windows
+
+    // Self-pipe used by glfwPostEmptyEvent to wake up glfwWaitEvents
+    int             emptyEventPipe[2];
 
     Atom            wmDeleteWindow;    // WM_DELETE_WINDOW atom
     Atom            wmName;            // _NET_WM_NAME atom
@@ -200,9 +229,23 @@ typedef struct _GLFWlibraryX11
         int         errorBase;
         int         majorVersion;
         int         minorVersion;
+        GLboolean   detectable;  // True if key repeats send no releases
     } Xkb;
 
-    // Key code LUT (mapping X11 key codes to GLFW key codes)
+    struct {
+        GLboolean   available;
+        int         majorOpcode;
+        int         eventBase;
+        int         errorBase;
+        int         majorVersion;
+        int         minorVersion;
+    } XI2;
+
+    // Input method used for composed and multi-character text input, if any
+    XIM             im;
+
+    // Key code LUT (mapping X11 key codes to GLFW key codes), updated when
+    // the keyboard mapping changes
     int             keyCodeLUT[256];
 
     // Screensaver data
@@ -260,6 +303,16 @@ typedef struct _GLFWlibraryGLX
 #if defined(_GLFW_DLOPEN_LIBGL)
     void*           libGL;  // dlopen handle for libGL.so
 #endif
+
+    // Usable window and pbuffer GLXFBConfigs of the screen, enumerated by
+    // the first window of each kind and kept until the screen configuration
+    // changes
+    struct _GLFWfbconfig* fbconfigs;
+    int*            fbconfigColumns;
+    unsigned int    fbconfigCount;
+    struct _GLFWfbconfig* pbufferFBConfigs;
+    int*            pbufferFBConfigColumns;
+    unsigned int    pbufferFBConfigCount;
 } _GLFWlibraryGLX;
 
 
@@ -273,6 +326,21 @@ GLFWGLOBAL struct {
     int           NumButtons;
     float*        Axis;
     unsigned char* Button;
+    char          Path[32];
+
+    // Ring buffer of events not yet retrieved by glfwGetJoystickEvents
+    GLFWjoystickevent* Events;
+    int           EventHead;
+    int           EventCount;
+
+#if defined(_GLFW_USE_LINUX_EVDEV)
+    int           AbsMap[ABS_CNT];  // evdev axis code to axis index, or -1
+    int           AbsMin[ABS_CNT];
+    int           AbsMax[ABS_CNT];
+    int           KeyMap[KEY_CNT - BTN_MISC]; // evdev button code to index
+    GLboolean     KernelTime; // Event timestamps use the timer clock
+    GLboolean     Dropped;    // Events were dropped until the next report
+#endif /*_GLFW_USE_LINUX_EVDEV*/
 } _glfwJoy[GLFW_JOYSTICK_LAST + 1];
 
 
@@ -282,6 +350,7 @@ GLFWGLOBAL struct {
 
 // Time
 void _glfwInitTimer(void);
+GLboolean _glfwConvertMonotonicTime(int64_t usec, double* time);
 
 // Fullscreen support
 int  _glfwGetClosestVideoMode(int* width, int* height, int* rate);
@@ -292,9 +361,22 @@ void _glfwRestoreVideoMode(void);
 // Joystick input
 void _glfwInitJoysticks(void);
 void _glfwTerminateJoysticks(void);
+void _glfwProcessJoystickEvents(void);
+int _glfwGetJoystickFD(void);
+int _glfwOpenJoystickFile(const char* path, int axes, int buttons);
+
+// OpenGL support
+struct _GLFWwindow;
+int  _glfwGetSwapInterval(struct _GLFWwindow* window);
+
+// Keyboard mapping
+void _glfwUpdateKeyCodeLUT(int firstKeyCode, int count);
 
 // Unicode support
+int _glfwInitKeySym2Unicode(void);
+void _glfwTerminateKeySym2Unicode(void);
 long _glfwKeySym2Unicode(KeySym keysym);
+const unsigned short* _glfwGetKeySymTable(int* count);
 
 // Clipboard handling
 GLboolean _glfwReadSelection(XSelectionEvent* request);
@@ -302,5 +384,6 @@ Atom _glfwWriteSelection(XSelectionRequestEvent* request);
 
 // Event processing
 void _glfwProcessPendingEvents(void);
+void _glfwFreeFBConfigCache(void);
 
 #endif // _platform_h_
@@ -83,6 +83,23 @@ void _glfwInitTimer(void)
 }
 
 
+//========================================================================
+// Convert a CLOCK_MONOTONIC time in microseconds to the time base of
+// glfwGetTime, which is only possible if the timer uses the same clock
+//========================================================================
+
+GLboolean _glfwConvertMonotonicTime(int64_t usec, double* time)
+{
+    if (!_glfwLibrary.X11.timer.monotonic)
+        return GL_FALSE;
+
+    *time = (double) (int64_t) ((uint64_t) usec * (uint64_t) 1000 -
+                                _glfwLibrary.X11.timer.base) *
+        _glfwLibrary.X11.timer.resolution;
+    return GL_TRUE;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW platform API                      //////
 //////////////////////////////////////////////////////////////////////////
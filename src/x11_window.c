@@ -33,6 +33,9 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
 
 // Action for EWMH client messages
 #define _NET_WM_STATE_REMOVE        0
@@ -98,6 +101,42 @@ static int translateChar(XKeyEvent* event)
 }
 
 
+//========================================================================
+// Looks up the text committed by the input method for a key press and
+// reports it as a single string
+//========================================================================
+
+static void inputText(_GLFWwindow* window, XKeyEvent* event)
+{
+    int count;
+    Status status;
+    char buffer[100];
+    char* text = buffer;
+
+    // Leave room for the terminator, as _glfwInputText needs it
+    count = Xutf8LookupString(window->X11.ic, event,
+                              buffer, sizeof(buffer) - 1,
+                              NULL, &status);
+
+    if (status == XBufferOverflow)
+    {
+        text = (char*) malloc(count + 1);
+        if (!text)
+            return;
+
+        count = Xutf8LookupString(window->X11.ic, event,
+                                  text, count,
+                                  NULL, &status);
+    }
+
+    if (status == XLookupChars || status == XLookupBoth)
+        _glfwInputText(window, text, count);
+
+    if (text != buffer)
+        free(text);
+}
+
+
 //========================================================================
 // Returns the specified attribute of the specified GLXFBConfig
 // NOTE: Do not call this unless we have found GLX 1.3+ or GLX_SGIX_fbconfig
@@ -120,10 +159,13 @@ static int getFBConfigAttrib(_GLFWwindow* window, GLXFBConfig fbconfig, int attr
 
 
 //========================================================================
-// Return a list of available and usable framebuffer configs
+// Return a list of available and usable framebuffer configs for the
+// specified drawable type
 //========================================================================
 
-static _GLFWfbconfig* getFBConfigs(_GLFWwindow* window, unsigned int* found)
+static _GLFWfbconfig* getFBConfigs(_GLFWwindow* window,
+                                   int drawableType,
+                                   unsigned int* found)
 {
     GLXFBConfig* fbconfigs;
     _GLFWfbconfig* result;
@@ -177,11 +219,15 @@ static _GLFWfbconfig* getFBConfigs(_GLFWwindow* window, unsigned int* found)
 
     for (i = 0;  i < count;  i++)
     {
-        if (!getFBConfigAttrib(window, fbconfigs[i], GLX_DOUBLEBUFFER) ||
-            !getFBConfigAttrib(window, fbconfigs[i], GLX_VISUAL_ID))
+        if (drawableType == GLX_WINDOW_BIT)
         {
-            // Only consider double-buffered GLXFBConfigs with associated visuals
-            continue;
+            if (!getFBConfigAttrib(window, fbconfigs[i], GLX_DOUBLEBUFFER) ||
+                !getFBConfigAttrib(window, fbconfigs[i], GLX_VISUAL_ID))
+            {
+                // Only consider double-buffered GLXFBConfigs with associated
+                // visuals for windows, as pbuffers are never presented
+                continue;
+            }
         }
 
         if (!(getFBConfigAttrib(window,
@@ -192,9 +238,9 @@ static _GLFWfbconfig* getFBConfigs(_GLFWwindow* window, unsigned int* found)
             continue;
         }
 
-        if (!(getFBConfigAttrib(window, fbconfigs[i], GLX_DRAWABLE_TYPE) & GLX_WINDOW_BIT))
+        if (!(getFBConfigAttrib(window, fbconfigs[i], GLX_DRAWABLE_TYPE) & drawableType))
         {
-            // Only consider window GLXFBConfigs
+            // Only consider GLXFBConfigs supporting the drawable type
             continue;
         }
 
@@ -231,57 +277,105 @@ static _GLFWfbconfig* getFBConfigs(_GLFWwindow* window, unsigned int* found)
 
 
 //========================================================================
-// Create the OpenGL context
+// Returns the usable GLXFBConfigs, enumerating them only if not cached
+//========================================================================
+
+static const _GLFWfbconfig* getCachedFBConfigs(_GLFWwindow* window,
+                                               unsigned int* found)
+{
+    _GLFWfbconfig** configs = &_glfwLibrary.GLX.fbconfigs;
+    unsigned int* count = &_glfwLibrary.GLX.fbconfigCount;
+    int drawableType = GLX_WINDOW_BIT;
+
+    if (window->mode == GLFW_OFFSCREEN)
+    {
+        configs = &_glfwLibrary.GLX.pbufferFBConfigs;
+        count = &_glfwLibrary.GLX.pbufferFBConfigCount;
+        drawableType = GLX_PBUFFER_BIT;
+    }
+
+    if (!*configs)
+    {
+        *configs = getFBConfigs(window, drawableType, count);
+        if (!*configs)
+            return NULL;
+    }
+
+    *found = *count;
+    return *configs;
+}
+
+
+//========================================================================
+// Returns the attribute columns of the cached GLXFBConfigs, building them
+// only if not cached
+// They are only needed to rank the fallbacks for an unusable GLXFBConfig,
+// so they are not built along with the configs
+//========================================================================
+
+static const int* getCachedFBConfigColumns(_GLFWwindow* window)
+{
+    int** columns = &_glfwLibrary.GLX.fbconfigColumns;
+    const _GLFWfbconfig* configs = _glfwLibrary.GLX.fbconfigs;
+    unsigned int count = _glfwLibrary.GLX.fbconfigCount;
+
+    if (window->mode == GLFW_OFFSCREEN)
+    {
+        columns = &_glfwLibrary.GLX.pbufferFBConfigColumns;
+        configs = _glfwLibrary.GLX.pbufferFBConfigs;
+        count = _glfwLibrary.GLX.pbufferFBConfigCount;
+    }
+
+    if (!*columns)
+        *columns = _glfwTransposeFBConfigs(configs, count);
+
+    return *columns;
+}
+
+
+//========================================================================
+// Retrieve the GLXFBConfig with the specified ID and its visual
+// Returns NULL, without reporting an error, if either is unavailable, as
+// the caller may move on to another GLXFBConfig
 //========================================================================
 
 #define setGLXattrib(attribs, index, attribName, attribValue) \
     attribs[index++] = attribName; \
     attribs[index++] = attribValue;
 
-static int createContext(_GLFWwindow* window,
-                         const _GLFWwndconfig* wndconfig,
-                         GLXFBConfigID fbconfigID)
+static GLXFBConfig* getGLXFBConfig(_GLFWwindow* window,
+                                   const _GLFWwndconfig* wndconfig,
+                                   GLXFBConfigID fbconfigID)
 {
-    int attribs[40];
-    int dummy, index;
+    int attribs[3];
+    int dummy, index = 0;
     GLXFBConfig* fbconfig;
-    GLXContext share = NULL;
 
-    if (wndconfig->share)
-        share = wndconfig->share->GLX.context;
+    setGLXattrib(attribs, index, GLX_FBCONFIG_ID, (int) fbconfigID);
+    setGLXattrib(attribs, index, None, None);
 
-    // Retrieve the previously selected GLXFBConfig
+    if (window->GLX.SGIX_fbconfig)
     {
-        index = 0;
-
-        setGLXattrib(attribs, index, GLX_FBCONFIG_ID, (int) fbconfigID);
-        setGLXattrib(attribs, index, None, None);
-
-        if (window->GLX.SGIX_fbconfig)
-        {
-            fbconfig = window->GLX.ChooseFBConfigSGIX(_glfwLibrary.X11.display,
-                                                      _glfwLibrary.X11.screen,
-                                                      attribs,
-                                                      &dummy);
-        }
-        else
-        {
-            fbconfig = glXChooseFBConfig(_glfwLibrary.X11.display,
-                                         _glfwLibrary.X11.screen,
-                                         attribs,
-                                         &dummy);
-        }
-
-        if (fbconfig == NULL)
-        {
-            _glfwSetError(GLFW_PLATFORM_ERROR,
-                          "X11/GLX: Failed to retrieve the selected GLXFBConfig");
-            return GL_FALSE;
-        }
+        fbconfig = window->GLX.ChooseFBConfigSGIX(_glfwLibrary.X11.display,
+                                                  _glfwLibrary.X11.screen,
+                                                  attribs,
+                                                  &dummy);
+    }
+    else
+    {
+        fbconfig = glXChooseFBConfig(_glfwLibrary.X11.display,
+                                     _glfwLibrary.X11.screen,
+                                     attribs,
+                                     &dummy);
     }
 
-    // Retrieve the corresponding visual
-    if (window->GLX.SGIX_fbconfig)
+    if (fbconfig == NULL)
+        return NULL;
+
+    // Retrieve the corresponding visual, which offscreen contexts lack
+    if (wndconfig->mode == GLFW_OFFSCREEN)
+        window->GLX.visual = NULL;
+    else if (window->GLX.SGIX_fbconfig)
     {
         window->GLX.visual = window->GLX.GetVisualFromFBConfigSGIX(_glfwLibrary.X11.display,
                                                                    *fbconfig);
@@ -292,15 +386,33 @@ static int createContext(_GLFWwindow* window,
                                                       *fbconfig);
     }
 
-    if (window->GLX.visual == NULL)
+    if (window->GLX.visual == NULL && wndconfig->mode != GLFW_OFFSCREEN)
     {
         XFree(fbconfig);
-
-        _glfwSetError(GLFW_PLATFORM_ERROR,
-                      "X11/GLX: Failed to retrieve visual for GLXFBConfig");
-        return GL_FALSE;
+        return NULL;
     }
 
+    return fbconfig;
+}
+
+
+//========================================================================
+// Create the OpenGL context for the specified GLXFBConfig, as returned by
+// getGLXFBConfig, which this function frees
+//========================================================================
+
+static int createContext(_GLFWwindow* window,
+                         const _GLFWwndconfig* wndconfig,
+                         GLXFBConfig* fbconfig,
+                         GLXFBConfigID fbconfigID)
+{
+    int attribs[40];
+    int index;
+    GLXContext share = NULL;
+
+    if (wndconfig->share)
+        share = wndconfig->share->GLX.context;
+
     if (window->GLX.ARB_create_context)
     {
         index = 0;
@@ -335,6 +447,8 @@ static int createContext(_GLFWwindow* window,
 
             if (!window->GLX.ARB_create_context_profile)
             {
+                XFree(fbconfig);
+
                 _glfwSetError(GLFW_VERSION_UNAVAILABLE,
                               "X11/GLX: An OpenGL profile requested but "
                               "GLX_ARB_create_context_profile is unavailable");
@@ -344,6 +458,8 @@ static int createContext(_GLFWwindow* window,
             if (wndconfig->glProfile == GLFW_OPENGL_ES2_PROFILE &&
                 !window->GLX.EXT_create_context_es2_profile)
             {
+                XFree(fbconfig);
+
                 _glfwSetError(GLFW_VERSION_UNAVAILABLE,
                               "X11/GLX: OpenGL ES 2.x profile requested but "
                               "GLX_EXT_create_context_es2_profile is unavailable");
@@ -366,6 +482,8 @@ static int createContext(_GLFWwindow* window,
 
             if (!window->GLX.ARB_create_context_robustness)
             {
+                XFree(fbconfig);
+
                 _glfwSetError(GLFW_VERSION_UNAVAILABLE,
                               "X11/GLX: An OpenGL robustness strategy was "
                               "requested but GLX_ARB_create_context_robustness "
@@ -423,10 +541,10 @@ static int createContext(_GLFWwindow* window,
         }
     }
 
-    XFree(fbconfig);
-
     if (window->GLX.context == NULL)
     {
+        XFree(fbconfig);
+
         // TODO: Handle all the various error codes here
 
         _glfwSetError(GLFW_PLATFORM_ERROR,
@@ -434,6 +552,35 @@ static int createContext(_GLFWwindow* window,
         return GL_FALSE;
     }
 
+    if (wndconfig->mode == GLFW_OFFSCREEN)
+    {
+        // Offscreen contexts render to a pbuffer of the requested size
+        // instead of a window, so no window or visual is ever created
+        const int pbufferAttribs[] =
+        {
+            GLX_PBUFFER_WIDTH, window->width,
+            GLX_PBUFFER_HEIGHT, window->height,
+            GLX_PRESERVED_CONTENTS, True,
+            None
+        };
+
+        window->GLX.pbuffer = glXCreatePbuffer(_glfwLibrary.X11.display,
+                                               *fbconfig,
+                                               pbufferAttribs);
+        if (!window->GLX.pbuffer)
+        {
+            XFree(fbconfig);
+
+            _glfwSetError(GLFW_PLATFORM_ERROR,
+                          "X11/GLX: Failed to create pbuffer");
+            return GL_FALSE;
+        }
+
+        window->GLX.drawable = window->GLX.pbuffer;
+    }
+
+    XFree(fbconfig);
+
     window->GLX.fbconfigID = fbconfigID;
 
     return GL_TRUE;
@@ -448,7 +595,11 @@ static int createContext(_GLFWwindow* window,
 
 static void initGLXExtensions(_GLFWwindow* window)
 {
-    if (_glfwPlatformExtensionSupported("GLX_EXT_swap_control"))
+    // Pbuffers are never presented, so swap control and frame statistics
+    // only apply to windows
+    const GLboolean presented = window->mode != GLFW_OFFSCREEN;
+
+    if (presented && _glfwPlatformExtensionSupported("GLX_EXT_swap_control"))
     {
         window->GLX.SwapIntervalEXT = (PFNGLXSWAPINTERVALEXTPROC)
             _glfwPlatformGetProcAddress("glXSwapIntervalEXT");
@@ -457,7 +608,7 @@ static void initGLXExtensions(_GLFWwindow* window)
             window->GLX.EXT_swap_control = GL_TRUE;
     }
 
-    if (_glfwPlatformExtensionSupported("GLX_SGI_swap_control"))
+    if (presented && _glfwPlatformExtensionSupported("GLX_SGI_swap_control"))
     {
         window->GLX.SwapIntervalSGI = (PFNGLXSWAPINTERVALSGIPROC)
             _glfwPlatformGetProcAddress("glXSwapIntervalSGI");
@@ -466,6 +617,21 @@ static void initGLXExtensions(_GLFWwindow* window)
             window->GLX.SGI_swap_control = GL_TRUE;
     }
 
+    if (window->GLX.EXT_swap_control)
+    {
+        if (_glfwPlatformExtensionSupported("GLX_EXT_swap_control_tear"))
+            window->GLX.EXT_swap_control_tear = GL_TRUE;
+    }
+
+    // GLX_SGI_swap_control does not allow an interval of zero
+    if (window->GLX.EXT_swap_control)
+        window->swapControl = GLFW_SWAP_INTERVAL_BIT | GLFW_SWAP_IMMEDIATE_BIT;
+    else if (window->GLX.SGI_swap_control)
+        window->swapControl = GLFW_SWAP_INTERVAL_BIT;
+
+    if (window->GLX.EXT_swap_control_tear)
+        window->swapControl |= GLFW_SWAP_TEAR_BIT;
+
     if (_glfwPlatformExtensionSupported("GLX_SGIX_fbconfig"))
     {
         window->GLX.GetFBConfigAttribSGIX = (PFNGLXGETFBCONFIGATTRIBSGIXPROC)
@@ -506,6 +672,17 @@ static void initGLXExtensions(_GLFWwindow* window)
 
     if (_glfwPlatformExtensionSupported("GLX_EXT_create_context_es2_profile"))
         window->GLX.EXT_create_context_es2_profile = GL_TRUE;
+
+    if (presented && _glfwPlatformExtensionSupported("GLX_OML_sync_control"))
+    {
+        window->GLX.GetSyncValuesOML = (PFNGLXGETSYNCVALUESOMLPROC)
+            _glfwPlatformGetProcAddress("glXGetSyncValuesOML");
+        window->GLX.WaitForSbcOML = (PFNGLXWAITFORSBCOMLPROC)
+            _glfwPlatformGetProcAddress("glXWaitForSbcOML");
+
+        if (window->GLX.GetSyncValuesOML && window->GLX.WaitForSbcOML)
+            window->GLX.OML_sync_control = GL_TRUE;
+    }
 }
 
 
@@ -570,6 +747,36 @@ static GLboolean createWindow(_GLFWwindow* window,
                           "X11/GLX: Failed to create window");
             return GL_FALSE;
         }
+
+        // Associate the GLFW window with the handle so that event dispatch
+        // can find it without walking the window list
+        XSaveContext(_glfwLibrary.X11.display,
+                     window->X11.handle,
+                     _glfwLibrary.X11.context,
+                     (XPointer) window);
+
+        if (_glfwLibrary.X11.im)
+        {
+            window->X11.ic = XCreateIC(_glfwLibrary.X11.im,
+                                       XNInputStyle,
+                                       XIMPreeditNothing | XIMStatusNothing,
+                                       XNClientWindow, window->X11.handle,
+                                       XNFocusWindow, window->X11.handle,
+                                       NULL);
+        }
+
+        if (window->X11.ic)
+        {
+            // The input method may need events we do not otherwise select
+            unsigned long filter = 0;
+
+            if (XGetICValues(window->X11.ic, XNFilterEvents, &filter, NULL) == NULL)
+            {
+                XSelectInput(_glfwLibrary.X11.display,
+                             window->X11.handle,
+                             wa.event_mask | filter);
+            }
+        }
     }
 
     if (window->mode == GLFW_FULLSCREEN && !_glfwLibrary.X11.hasEWMH)
@@ -687,6 +894,29 @@ static void hideMouseCursor(_GLFWwindow* window)
 }
 
 
+//========================================================================
+// Enable or disable delivery of raw pointer motion
+// Raw events are only ever delivered to the root window
+//========================================================================
+
+static void selectRawMotion(GLboolean enabled)
+{
+#if defined(_GLFW_HAS_XINPUT2)
+    XIEventMask em;
+    unsigned char mask[XIMaskLen(XI_RawMotion)] = { 0 };
+
+    em.deviceid = XIAllMasterDevices;
+    em.mask_len = sizeof(mask);
+    em.mask = mask;
+
+    if (enabled)
+        XISetMask(mask, XI_RawMotion);
+
+    XISelectEvents(_glfwLibrary.X11.display, _glfwLibrary.X11.root, &em, 1);
+#endif /*_GLFW_HAS_XINPUT2*/
+}
+
+
 //========================================================================
 // Capture mouse cursor
 //========================================================================
@@ -705,6 +935,14 @@ static void captureMouseCursor(_GLFWwindow* window)
         {
             window->X11.cursorGrabbed = GL_TRUE;
             window->X11.cursorCentered = GL_FALSE;
+
+            // With raw motion, the pointer never needs to be re-centered
+            if (_glfwLibrary.X11.XI2.available)
+            {
+                window->X11.rawMotionX = 0.0;
+                window->X11.rawMotionY = 0.0;
+                selectRawMotion(GL_TRUE);
+            }
         }
     }
 }
@@ -721,6 +959,9 @@ static void showMouseCursor(_GLFWwindow* window)
     // area)
     if (window->X11.cursorGrabbed)
     {
+        if (_glfwLibrary.X11.XI2.available)
+            selectRawMotion(GL_FALSE);
+
         XUngrabPointer(_glfwLibrary.X11.display, CurrentTime);
         window->X11.cursorGrabbed = GL_FALSE;
     }
@@ -887,33 +1128,116 @@ static _GLFWwindow* findWindow(Window handle)
 {
     _GLFWwindow* window;
 
-    for (window = _glfwLibrary.windowListHead;  window;  window = window->next)
+    // The association is made in createWindow and removed in
+    // _glfwPlatformCloseWindow, so XFindContext is the authority here
+    if (XFindContext(_glfwLibrary.X11.display,
+                     handle,
+                     _glfwLibrary.X11.context,
+                     (XPointer*) &window) != 0)
     {
-        if (window->X11.handle == handle)
-            return window;
+        return NULL;
     }
 
-    return NULL;
+    return window;
 }
 
 
 //========================================================================
-// Get and process next X event (called by _glfwPlatformPollEvents)
+// Remember the server timestamp of the specified input event
 //========================================================================
 
-static void processSingleEvent(void)
+static void updateEventTime(XEvent* event)
+{
+    Time time;
+
+    switch (event->type)
+    {
+        case KeyPress:
+        case KeyRelease:
+            time = event->xkey.time;
+            break;
+        case ButtonPress:
+        case ButtonRelease:
+            time = event->xbutton.time;
+            break;
+        case MotionNotify:
+            time = event->xmotion.time;
+            break;
+        case EnterNotify:
+        case LeaveNotify:
+            time = event->xcrossing.time;
+            break;
+        default:
+            return;
+    }
+
+    // Server timestamps are in milliseconds
+    _glfwLibrary.eventTime = (double) time / 1000.0;
+}
+
+
+#if defined(_GLFW_HAS_XINPUT2)
+
+//========================================================================
+// Report raw motion to the window that has captured the cursor
+// Sub-pixel motion is accumulated until it adds up to whole units
+//========================================================================
+
+static void processRawMotion(const XIRawEvent* event)
+{
+    int x, y;
+    const double* values = event->raw_values;
+    _GLFWwindow* window = _glfwLibrary.activeWindow;
+
+    if (!window || !window->X11.cursorGrabbed ||
+        window->cursorMode != GLFW_CURSOR_CAPTURED)
+    {
+        return;
+    }
+
+    // Values are only present for the valuators set in the mask
+    if (XIMaskIsSet(event->valuators.mask, 0))
+        window->X11.rawMotionX += *values++;
+    if (XIMaskIsSet(event->valuators.mask, 1))
+        window->X11.rawMotionY += *values++;
+
+    x = (int) window->X11.rawMotionX;
+    y = (int) window->X11.rawMotionY;
+
+    window->X11.rawMotionX -= x;
+    window->X11.rawMotionY -= y;
+
+    // Server timestamps are in milliseconds
+    _glfwLibrary.eventTime = (double) event->time / 1000.0;
+
+    _glfwInputCursorMotion(window, x, y);
+}
+
+#endif /*_GLFW_HAS_XINPUT2*/
+
+
+//========================================================================
+// Process the specified X event
+//========================================================================
+
+static void processEvent(XEvent* event)
 {
     _GLFWwindow* window;
+    Bool filtered = False;
 
-    XEvent event;
-    XNextEvent(_glfwLibrary.X11.display, &event);
+    // Let the input method see every event first, as it may need more than
+    // key presses to track its state
+    if (_glfwLibrary.X11.im)
+        filtered = XFilterEvent(event, None);
 
-    switch (event.type)
+    updateEventTime(event);
+
+    switch (event->type)
     {
         case KeyPress:
         {
             // A keyboard key was pressed
-            window = findWindow(event.xkey.window);
+            window = findWindow(event->xkey.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for KeyPress event\n");
@@ -921,10 +1245,27 @@ static void processSingleEvent(void)
             }
 
             // Translate and report key press
-            _glfwInputKey(window, translateKey(event.xkey.keycode), GLFW_PRESS);
+            // Input methods that forward key events (such as ibus and fcitx)
+            // filter the original press and then send it again with the same
+            // time stamp, so only the first press of a key at any given time
+            // is reported. The server never sends a time stamp of zero, so the
+            // first press of each key always gets through
+            if (event->xkey.time != window->X11.keyPressTimes[event->xkey.keycode])
+            {
+                window->X11.keyPressTimes[event->xkey.keycode] = event->xkey.time;
+                _glfwInputKey(window, translateKey(event->xkey.keycode), GLFW_PRESS);
+            }
 
-            // Translate and report character input
-            _glfwInputChar(window, translateChar(&event.xkey));
+            // Translate and report character input. With an input context,
+            // events swallowed by the input method (dead keys and the like)
+            // produce no text, and whatever it commits is reported at once
+            if (window->X11.ic)
+            {
+                if (!filtered)
+                    inputText(window, &event->xkey);
+            }
+            else
+                _glfwInputChar(window, translateChar(&event->xkey));
 
             break;
         }
@@ -932,32 +1273,34 @@ static void processSingleEvent(void)
         case KeyRelease:
         {
             // A keyboard key was released
-            window = findWindow(event.xkey.window);
+            window = findWindow(event->xkey.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for KeyRelease event\n");
                 return;
             }
 
-            // Do not report key releases for key repeats. For key repeats we
-            // will get KeyRelease/KeyPress pairs with similar or identical
+            // Do not report key releases for key repeats. With detectable
+            // auto-repeat, the server sends no such releases. Otherwise, key
+            // repeats are KeyRelease/KeyPress pairs with similar or identical
             // time stamps. User selected key repeat filtering is handled in
             // _glfwInputKey/_glfwInputChar.
-            if (XEventsQueued(_glfwLibrary.X11.display, QueuedAfterReading))
+            if (!_glfwLibrary.X11.Xkb.detectable &&
+                XEventsQueued(_glfwLibrary.X11.display, QueuedAfterReading))
             {
                 XEvent nextEvent;
                 XPeekEvent(_glfwLibrary.X11.display, &nextEvent);
 
                 if (nextEvent.type == KeyPress &&
-                    nextEvent.xkey.window == event.xkey.window &&
-                    nextEvent.xkey.keycode == event.xkey.keycode)
+                    nextEvent.xkey.window == event->xkey.window &&
+                    nextEvent.xkey.keycode == event->xkey.keycode)
                 {
                     // This last check is a hack to work around key repeats
                     // leaking through due to some sort of time drift
                     // Toshiyuki Takahashi can press a button 16 times per
                     // second so it's fairly safe to assume that no human is
                     // pressing the key 50 times per second (value is ms)
-                    if ((nextEvent.xkey.time - event.xkey.time) < 20)
+                    if ((nextEvent.xkey.time - event->xkey.time) < 20)
                     {
                         // Do not report anything for this event
                         break;
@@ -966,7 +1309,7 @@ static void processSingleEvent(void)
             }
 
             // Translate and report key release
-            _glfwInputKey(window, translateKey(event.xkey.keycode), GLFW_RELEASE);
+            _glfwInputKey(window, translateKey(event->xkey.keycode), GLFW_RELEASE);
 
             break;
         }
@@ -974,30 +1317,30 @@ static void processSingleEvent(void)
         case ButtonPress:
         {
             // A mouse button was pressed or a scrolling event occurred
-            window = findWindow(event.xbutton.window);
+            window = findWindow(event->xbutton.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for ButtonPress event\n");
                 return;
             }
 
-            if (event.xbutton.button == Button1)
+            if (event->xbutton.button == Button1)
                 _glfwInputMouseClick(window, GLFW_MOUSE_BUTTON_LEFT, GLFW_PRESS);
-            else if (event.xbutton.button == Button2)
+            else if (event->xbutton.button == Button2)
                 _glfwInputMouseClick(window, GLFW_MOUSE_BUTTON_MIDDLE, GLFW_PRESS);
-            else if (event.xbutton.button == Button3)
+            else if (event->xbutton.button == Button3)
                 _glfwInputMouseClick(window, GLFW_MOUSE_BUTTON_RIGHT, GLFW_PRESS);
 
             // XFree86 3.3.2 and later translates mouse wheel up/down into
             // mouse button 4 & 5 presses
-            else if (event.xbutton.button == Button4)
+            else if (event->xbutton.button == Button4)
                 _glfwInputScroll(window, 0.0, 1.0);
-            else if (event.xbutton.button == Button5)
+            else if (event->xbutton.button == Button5)
                 _glfwInputScroll(window, 0.0, -1.0);
 
-            else if (event.xbutton.button == Button6)
+            else if (event->xbutton.button == Button6)
                 _glfwInputScroll(window, -1.0, 0.0);
-            else if (event.xbutton.button == Button7)
+            else if (event->xbutton.button == Button7)
                 _glfwInputScroll(window, 1.0, 0.0);
 
             break;
@@ -1006,26 +1349,26 @@ static void processSingleEvent(void)
         case ButtonRelease:
         {
             // A mouse button was released
-            window = findWindow(event.xbutton.window);
+            window = findWindow(event->xbutton.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for ButtonRelease event\n");
                 return;
             }
 
-            if (event.xbutton.button == Button1)
+            if (event->xbutton.button == Button1)
             {
                 _glfwInputMouseClick(window,
                                      GLFW_MOUSE_BUTTON_LEFT,
                                      GLFW_RELEASE);
             }
-            else if (event.xbutton.button == Button2)
+            else if (event->xbutton.button == Button2)
             {
                 _glfwInputMouseClick(window,
                                      GLFW_MOUSE_BUTTON_MIDDLE,
                                      GLFW_RELEASE);
             }
-            else if (event.xbutton.button == Button3)
+            else if (event->xbutton.button == Button3)
             {
                 _glfwInputMouseClick(window,
                                      GLFW_MOUSE_BUTTON_RIGHT,
@@ -1037,7 +1380,7 @@ static void processSingleEvent(void)
         case EnterNotify:
         {
             // The mouse cursor enters the Window
-            window = findWindow(event.xcrossing.window);
+            window = findWindow(event->xcrossing.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for EnterNotify event\n");
@@ -1054,7 +1397,7 @@ static void processSingleEvent(void)
         case LeaveNotify:
         {
             // The mouse cursor leave the Window
-            window = findWindow(event.xcrossing.window);
+            window = findWindow(event->xcrossing.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for LeaveNotify event\n");
@@ -1071,35 +1414,40 @@ static void processSingleEvent(void)
         case MotionNotify:
         {
             // The mouse cursor was moved
-            window = findWindow(event.xmotion.window);
+            window = findWindow(event->xmotion.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for MotionNotify event\n");
                 return;
             }
 
-            if (event.xmotion.x != window->X11.cursorPosX ||
-                event.xmotion.y != window->X11.cursorPosY)
+            if (event->xmotion.x != window->X11.cursorPosX ||
+                event->xmotion.y != window->X11.cursorPosY)
             {
                 // The mouse cursor was moved and we didn't do it
                 int x, y;
 
                 if (window->cursorMode == GLFW_CURSOR_CAPTURED)
                 {
-                    if (_glfwLibrary.activeWindow != window)
+                    // Raw motion is reported instead while grabbed
+                    if (_glfwLibrary.activeWindow != window ||
+                        (window->X11.cursorGrabbed &&
+                         _glfwLibrary.X11.XI2.available))
+                    {
                         break;
+                    }
 
-                    x = event.xmotion.x - window->X11.cursorPosX;
-                    y = event.xmotion.y - window->X11.cursorPosY;
+                    x = event->xmotion.x - window->X11.cursorPosX;
+                    y = event->xmotion.y - window->X11.cursorPosY;
                 }
                 else
                 {
-                    x = event.xmotion.x;
-                    y = event.xmotion.y;
+                    x = event->xmotion.x;
+                    y = event->xmotion.y;
                 }
 
-                window->X11.cursorPosX = event.xmotion.x;
-                window->X11.cursorPosY = event.xmotion.y;
+                window->X11.cursorPosX = event->xmotion.x;
+                window->X11.cursorPosY = event->xmotion.y;
                 window->X11.cursorCentered = GL_FALSE;
 
                 _glfwInputCursorMotion(window, x, y);
@@ -1111,7 +1459,7 @@ static void processSingleEvent(void)
         case ConfigureNotify:
         {
             // The window configuration changed somehow
-            window = findWindow(event.xconfigure.window);
+            window = findWindow(event->xconfigure.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for ConfigureNotify event\n");
@@ -1119,12 +1467,12 @@ static void processSingleEvent(void)
             }
 
             _glfwInputWindowSize(window,
-                                 event.xconfigure.width,
-                                 event.xconfigure.height);
+                                 event->xconfigure.width,
+                                 event->xconfigure.height);
 
             _glfwInputWindowPos(window,
-                                event.xconfigure.x,
-                                event.xconfigure.y);
+                                event->xconfigure.x,
+                                event->xconfigure.y);
 
             break;
         }
@@ -1132,14 +1480,14 @@ static void processSingleEvent(void)
         case ClientMessage:
         {
             // Custom client message, probably from the window manager
-            window = findWindow(event.xclient.window);
+            window = findWindow(event->xclient.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for ClientMessage event\n");
                 return;
             }
 
-            if ((Atom) event.xclient.data.l[0] == _glfwLibrary.X11.wmDeleteWindow)
+            if ((Atom) event->xclient.data.l[0] == _glfwLibrary.X11.wmDeleteWindow)
             {
                 // The window manager was asked to close the window, for example by
                 // the user pressing a 'close' window decoration button
@@ -1147,17 +1495,17 @@ static void processSingleEvent(void)
                 window->closeRequested = GL_TRUE;
             }
             else if (_glfwLibrary.X11.wmPing != None &&
-                     (Atom) event.xclient.data.l[0] == _glfwLibrary.X11.wmPing)
+                     (Atom) event->xclient.data.l[0] == _glfwLibrary.X11.wmPing)
             {
                 // The window manager is pinging us to make sure we are still
                 // responding to events
 
-                event.xclient.window = _glfwLibrary.X11.root;
+                event->xclient.window = _glfwLibrary.X11.root;
                 XSendEvent(_glfwLibrary.X11.display,
-                           event.xclient.window,
+                           event->xclient.window,
                            False,
                            SubstructureNotifyMask | SubstructureRedirectMask,
-                           &event);
+                           event);
             }
 
             break;
@@ -1166,7 +1514,7 @@ static void processSingleEvent(void)
         case MapNotify:
         {
             // The window was mapped
-            window = findWindow(event.xmap.window);
+            window = findWindow(event->xmap.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for MapNotify event\n");
@@ -1180,7 +1528,7 @@ static void processSingleEvent(void)
         case UnmapNotify:
         {
             // The window was unmapped
-            window = findWindow(event.xmap.window);
+            window = findWindow(event->xmap.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for UnmapNotify event\n");
@@ -1194,13 +1542,16 @@ static void processSingleEvent(void)
         case FocusIn:
         {
             // The window gained focus
-            window = findWindow(event.xfocus.window);
+            window = findWindow(event->xfocus.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for FocusIn event\n");
                 return;
             }
 
+            if (window->X11.ic)
+                XSetICFocus(window->X11.ic);
+
             _glfwInputWindowFocus(window, GL_TRUE);
 
             if (window->cursorMode == GLFW_CURSOR_CAPTURED)
@@ -1212,13 +1563,16 @@ static void processSingleEvent(void)
         case FocusOut:
         {
             // The window lost focus
-            window = findWindow(event.xfocus.window);
+            window = findWindow(event->xfocus.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for FocusOut event\n");
                 return;
             }
 
+            if (window->X11.ic)
+                XUnsetICFocus(window->X11.ic);
+
             _glfwInputWindowFocus(window, GL_FALSE);
 
             if (window->cursorMode == GLFW_CURSOR_CAPTURED)
@@ -1230,7 +1584,7 @@ static void processSingleEvent(void)
         case Expose:
         {
             // The window's contents was damaged
-            window = findWindow(event.xexpose.window);
+            window = findWindow(event->xexpose.window);
             if (window == NULL)
             {
                 fprintf(stderr, "Cannot find GLFW window structure for Expose event\n");
@@ -1254,7 +1608,7 @@ static void processSingleEvent(void)
         {
             // The selection conversion status is available
 
-            XSelectionEvent* request = &event.xselection;
+            XSelectionEvent* request = &event->xselection;
 
             if (_glfwReadSelection(request))
                 _glfwLibrary.X11.selection.status = _GLFW_CONVERSION_SUCCEEDED;
@@ -1268,7 +1622,7 @@ static void processSingleEvent(void)
         {
             // The contents of the selection was requested
 
-            XSelectionRequestEvent* request = &event.xselectionrequest;
+            XSelectionRequestEvent* request = &event->xselectionrequest;
 
             XEvent response;
             memset(&response, 0, sizeof(response));
@@ -1290,15 +1644,72 @@ static void processSingleEvent(void)
         case DestroyNotify:
             return;
 
+        case MappingNotify:
+        {
+            // The core keyboard mapping changed
+            if (event->xmapping.request == MappingKeyboard)
+            {
+                XRefreshKeyboardMapping(&event->xmapping);
+                _glfwUpdateKeyCodeLUT(event->xmapping.first_keycode,
+                                      event->xmapping.count);
+            }
+
+            break;
+        }
+
+#if defined(_GLFW_HAS_XINPUT2)
+        case GenericEvent:
+        {
+            // Extension events carry their data in a separate cookie
+            if (event->xcookie.extension == _glfwLibrary.X11.XI2.majorOpcode &&
+                XGetEventData(_glfwLibrary.X11.display, &event->xcookie))
+            {
+                if (event->xcookie.evtype == XI_RawMotion)
+                    processRawMotion((XIRawEvent*) event->xcookie.data);
+
+                XFreeEventData(_glfwLibrary.X11.display, &event->xcookie);
+            }
+
+            break;
+        }
+#endif /*_GLFW_HAS_XINPUT2*/
+
         default:
         {
+#if defined(_GLFW_HAS_XKB)
+            if (_glfwLibrary.X11.Xkb.available &&
+                event->type == _glfwLibrary.X11.Xkb.eventBase)
+            {
+                XkbEvent* xkb = (XkbEvent*) event;
+
+                if (xkb->any.xkb_type == XkbNewKeyboardNotify)
+                {
+                    // A different keyboard may have different key names
+                    _glfwUpdateKeyCodeLUT(0, 256);
+                }
+                else if (xkb->any.xkb_type == XkbMapNotify &&
+                         (xkb->map.changed & XkbKeySymsMask))
+                {
+                    XkbRefreshKeyboardMapping(&xkb->map);
+                    _glfwUpdateKeyCodeLUT(xkb->map.first_key_sym,
+                                          xkb->map.num_key_syms);
+                }
+
+                break;
+            }
+#endif /*_GLFW_HAS_XKB*/
+
 #if defined(_GLFW_HAS_XRANDR)
-            switch (event.type - _glfwLibrary.X11.RandR.eventBase)
+            switch (event->type - _glfwLibrary.X11.RandR.eventBase)
             {
                 case RRScreenChangeNotify:
                 {
                     // Show XRandR that we really care
-                    XRRUpdateConfiguration(&event);
+                    XRRUpdateConfiguration(event);
+
+                    // The set of GLXFBConfigs may have changed with the
+                    // screen configuration, so enumerate them again
+                    _glfwFreeFBConfigCache();
                     break;
                 }
             }
@@ -1309,6 +1720,94 @@ static void processSingleEvent(void)
 }
 
 
+//========================================================================
+// Drain the empty event pipe of any pending wake-up bytes
+//========================================================================
+
+static void drainEmptyEvents(void)
+{
+    char dummy[64];
+
+    while (read(_glfwLibrary.X11.emptyEventPipe[0], dummy, sizeof(dummy)) > 0)
+        ;
+}
+
+
+//========================================================================
+// Wait until there are events in the queue, a joystick has input or is
+// connected or disconnected, an empty event is posted or the timeout has
+// elapsed
+// A negative timeout means wait indefinitely
+// Returns GL_TRUE if there are events to process
+//========================================================================
+
+static GLboolean waitForEvent(double timeout)
+{
+    struct pollfd fds[3];
+    const double deadline = _glfwPlatformGetTime() + timeout;
+
+    fds[0].fd = ConnectionNumber(_glfwLibrary.X11.display);
+    fds[0].events = POLLIN;
+    fds[1].fd = _glfwLibrary.X11.emptyEventPipe[0];
+    fds[1].events = POLLIN;
+
+    // Negative descriptors are ignored by poll, so this is safe even when
+    // joystick support is unavailable
+    fds[2].fd = _glfwGetJoystickFD();
+    fds[2].events = POLLIN;
+
+    // XPending also reads any data that has arrived on the connection, so
+    // we only need to poll when the event queue is actually empty
+    while (!XPending(_glfwLibrary.X11.display))
+    {
+        int result, milliseconds = -1;
+
+        if (timeout >= 0.0)
+        {
+            const double remaining = deadline - _glfwPlatformGetTime();
+            if (remaining <= 0.0)
+                return GL_FALSE;
+
+            // Round up so we never wake up just short of the deadline
+            // Very long (or infinite) timeouts are waited out in slices of
+            // the longest interval poll accepts
+            if (remaining * 1000.0 < (double) (INT_MAX - 1))
+                milliseconds = (int) (remaining * 1000.0) + 1;
+            else
+                milliseconds = INT_MAX;
+        }
+
+        // Timeouts are checked against the deadline at the top of the loop
+        result = poll(fds, 3, milliseconds);
+        if (result == 0)
+            continue;
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return GL_FALSE;
+        }
+
+        if (fds[1].revents & POLLIN)
+        {
+            // Another thread posted an empty event, which is drained by the
+            // event processing that follows every wait
+            return GL_TRUE;
+        }
+
+        if (fds[2].revents & POLLIN)
+        {
+            // Joystick events are processed along with window events
+            return GL_TRUE;
+        }
+    }
+
+    return GL_TRUE;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 //////                       GLFW internal API                      //////
 //////////////////////////////////////////////////////////////////////////
@@ -1319,10 +1818,41 @@ static void processSingleEvent(void)
 
 void _glfwProcessPendingEvents(void)
 {
-    int i, count = XPending(_glfwLibrary.X11.display);
+    int i, count;
+    XEvent event;
 
-    for (i = 0;  i < count;  i++)
-        processSingleEvent();
+    // Drain the queue in batches, only flushing and reading from the X
+    // connection once per batch instead of once per event
+    // Event handlers may read further events into the queue (for example
+    // the key repeat detection), which are picked up by the next batch
+    while ((count = XEventsQueued(_glfwLibrary.X11.display, QueuedAfterFlush)))
+    {
+        for (i = 0;  i < count;  i++)
+        {
+            XNextEvent(_glfwLibrary.X11.display, &event);
+            processEvent(&event);
+        }
+
+        _glfwLibrary.eventCount += count;
+    }
+}
+
+
+//========================================================================
+// Frees the cached GLXFBConfigs and their attribute columns, so that they
+// are enumerated again by the next window
+//========================================================================
+
+void _glfwFreeFBConfigCache(void)
+{
+    free(_glfwLibrary.GLX.fbconfigs);
+    _glfwLibrary.GLX.fbconfigs = NULL;
+    free(_glfwLibrary.GLX.pbufferFBConfigs);
+    _glfwLibrary.GLX.pbufferFBConfigs = NULL;
+    free(_glfwLibrary.GLX.fbconfigColumns);
+    _glfwLibrary.GLX.fbconfigColumns = NULL;
+    free(_glfwLibrary.GLX.pbufferFBConfigColumns);
+    _glfwLibrary.GLX.pbufferFBConfigColumns = NULL;
 }
 
 
@@ -1339,20 +1869,31 @@ int _glfwPlatformOpenWindow(_GLFWwindow* window,
                             const _GLFWwndconfig* wndconfig,
                             const _GLFWfbconfig* fbconfig)
 {
-    _GLFWfbconfig closest;
 
     window->refreshRate = wndconfig->refreshRate;
     window->resizable   = wndconfig->resizable;
 
+    if (wndconfig->mode == GLFW_OFFSCREEN &&
+        _glfwLibrary.GLX.majorVersion == 1 && _glfwLibrary.GLX.minorVersion < 3)
+    {
+        _glfwSetError(GLFW_OPENGL_UNAVAILABLE,
+                      "X11/GLX: Offscreen contexts require GLX 1.3 or later");
+        return GL_FALSE;
+    }
+
     initGLXExtensions(window);
 
-    // Choose the best available fbconfig
+    // Choose the best available fbconfig and create the context, falling
+    // back to the next best one if the GLXFBConfig turns out to be unusable
     {
-        unsigned int fbcount;
-        _GLFWfbconfig* fbconfigs;
-        const _GLFWfbconfig* result;
-
-        fbconfigs = getFBConfigs(window, &fbcount);
+        unsigned int i, fbcount, ranked;
+        unsigned int* ranking;
+        const _GLFWfbconfig* fbconfigs;
+        const _GLFWfbconfig* closest;
+        const int* columns;
+        GLXFBConfig* native;
+
+        fbconfigs = getCachedFBConfigs(window, &fbcount);
         if (!fbconfigs)
         {
             _glfwSetError(GLFW_PLATFORM_ERROR,
@@ -1360,40 +1901,83 @@ int _glfwPlatformOpenWindow(_GLFWwindow* window,
             return GL_FALSE;
         }
 
-        result = _glfwChooseFBConfig(fbconfig, fbconfigs, fbcount);
-        if (!result)
+        closest = _glfwChooseFBConfig(fbconfig, fbconfigs, fbcount);
+        if (!closest)
         {
             _glfwSetError(GLFW_PLATFORM_ERROR,
                           "X11/GLX: No GLXFBConfig matched the criteria");
-
-            free(fbconfigs);
             return GL_FALSE;
         }
 
-        closest = *result;
-        free(fbconfigs);
+        native = getGLXFBConfig(window, wndconfig,
+                                (GLXFBConfigID) closest->platformID);
+
+        // Only move on to the next candidate if the GLXFBConfig or its visual
+        // could not be retrieved, as any later failure is caused by the
+        // context hints rather than the GLXFBConfig
+        // The remaining candidates are only ranked if it comes to that, and
+        // no error is reported unless they all fail
+        if (!native)
+        {
+            columns = getCachedFBConfigColumns(window);
+            if (!columns)
+                return GL_FALSE;
+
+            ranking = (unsigned int*) malloc(sizeof(unsigned int) * fbcount);
+            if (!ranking)
+            {
+                _glfwSetError(GLFW_OUT_OF_MEMORY,
+                              "X11/GLX: Failed to allocate GLXFBConfig ranking");
+                return GL_FALSE;
+            }
+
+            ranked = _glfwRankFBConfigs(fbconfig, columns, fbcount, ranking);
+
+            for (i = 0;  i < ranked;  i++)
+            {
+                if (fbconfigs + ranking[i] == closest)
+                    continue;
+
+                native = getGLXFBConfig(window, wndconfig,
+                                        (GLXFBConfigID) fbconfigs[ranking[i]].platformID);
+                if (native)
+                {
+                    closest = fbconfigs + ranking[i];
+                    break;
+                }
+            }
+
+            free(ranking);
+
+            if (!native)
+            {
+                _glfwSetError(GLFW_PLATFORM_ERROR,
+                              "X11/GLX: Failed to retrieve a visual for any "
+                              "matching GLXFBConfig");
+                return GL_FALSE;
+            }
+        }
+
+        if (!createContext(window, wndconfig, native,
+                           (GLXFBConfigID) closest->platformID))
+        {
+            return GL_FALSE;
+        }
     }
 
-    if (!createContext(window, wndconfig, (GLXFBConfigID) closest.platformID))
-        return GL_FALSE;
+    // Offscreen contexts are complete once their pbuffer exists
+    if (wndconfig->mode == GLFW_OFFSCREEN)
+        return GL_TRUE;
 
     if (!createWindow(window, wndconfig))
         return GL_FALSE;
 
-    if (wndconfig->mode == GLFW_FULLSCREEN)
-    {
-#if defined(_GLFW_HAS_XRANDR)
-        // Request screen change notifications
-        if (_glfwLibrary.X11.RandR.available)
-        {
-            XRRSelectInput(_glfwLibrary.X11.display,
-                           window->X11.handle,
-                           RRScreenChangeNotifyMask);
-        }
-#endif /*_GLFW_HAS_XRANDR*/
+    window->GLX.drawable = window->X11.handle;
 
+    // Screen change notifications are selected on the root window by
+    // initDisplay, for windowed and fullscreen windows alike
+    if (wndconfig->mode == GLFW_FULLSCREEN)
         enterFullscreenMode(window);
-    }
 
     // Process the window map event and any other that may have arrived
     _glfwProcessPendingEvents();
@@ -1433,20 +2017,36 @@ void _glfwPlatformCloseWindow(_GLFWwindow* window)
 
     if (window->GLX.context)
     {
-        // Release and destroy the context
-        glXMakeCurrent(_glfwLibrary.X11.display, None, NULL);
+        // The context has already been released by glfwCloseWindow if it
+        // was current, and releasing here would detach any other context
         glXDestroyContext(_glfwLibrary.X11.display, window->GLX.context);
         window->GLX.context = NULL;
     }
 
+    if (window->GLX.pbuffer)
+    {
+        glXDestroyPbuffer(_glfwLibrary.X11.display, window->GLX.pbuffer);
+        window->GLX.pbuffer = None;
+    }
+
     if (window->GLX.visual)
     {
         XFree(window->GLX.visual);
         window->GLX.visual = NULL;
     }
 
+    if (window->X11.ic)
+    {
+        XDestroyIC(window->X11.ic);
+        window->X11.ic = NULL;
+    }
+
     if (window->X11.handle)
     {
+        XDeleteContext(_glfwLibrary.X11.display,
+                       window->X11.handle,
+                       _glfwLibrary.X11.context);
+
         XUnmapWindow(_glfwLibrary.X11.display, window->X11.handle);
         XDestroyWindow(_glfwLibrary.X11.display, window->X11.handle);
         window->X11.handle = (Window) 0;
@@ -1614,7 +2214,7 @@ void _glfwPlatformRefreshWindowParams(void)
     int dotclock;
     float pixels_per_second, pixels_per_frame;
 #endif /*_GLFW_HAS_XF86VIDMODE*/
-    _GLFWwindow* window = _glfwLibrary.currentWindow;
+    _GLFWwindow* window = _glfwCurrentWindow;
 
     int attribs[] = { GLX_FBCONFIG_ID, window->GLX.fbconfigID, None };
 
@@ -1695,6 +2295,8 @@ void _glfwPlatformRefreshWindowParams(void)
         window->refreshRate = 0;
     }
 
+    window->swapInterval = _glfwGetSwapInterval(window);
+
     XFree(fbconfig);
 }
 
@@ -1707,16 +2309,26 @@ void _glfwPlatformPollEvents(void)
 {
     _GLFWwindow* window;
 
+    // Discard any empty events posted since the last poll or wait, whether
+    // or not it was one of them that woke us, so that they cannot pile up
+    // and cut short later waits
+    drainEmptyEvents();
+
     // Process all pending events
-    while (XPending(_glfwLibrary.X11.display))
-        processSingleEvent();
+    _glfwProcessPendingEvents();
+
+    // Update the cached state of joysticks with pending input
+    _glfwProcessJoystickEvents();
 
     // Did the cursor move in an active window that has captured the cursor
     window = _glfwLibrary.activeWindow;
     if (window)
     {
+        // Raw motion is unaffected by the pointer reaching the edge of the
+        // window, so the pointer only needs to be re-centered without it
         if (window->cursorMode == GLFW_CURSOR_CAPTURED &&
-            !window->X11.cursorCentered)
+            !window->X11.cursorCentered &&
+            !(window->X11.cursorGrabbed && _glfwLibrary.X11.XI2.available))
         {
             _glfwPlatformSetMouseCursorPos(window,
                                            window->width / 2,
@@ -1738,16 +2350,38 @@ void _glfwPlatformPollEvents(void)
 
 void _glfwPlatformWaitEvents(void)
 {
-    XEvent event;
-
     // Block waiting for an event to arrive
-    XNextEvent(_glfwLibrary.X11.display, &event);
-    XPutBackEvent(_glfwLibrary.X11.display, &event);
+    waitForEvent(-1.0);
+
+    _glfwPlatformPollEvents();
+}
+
+
+//========================================================================
+// Wait for new window and input events or until the timeout has elapsed
+//========================================================================
+
+void _glfwPlatformWaitEventsTimeout(double timeout)
+{
+    waitForEvent(timeout);
 
     _glfwPlatformPollEvents();
 }
 
 
+//========================================================================
+// Post an empty event to wake up a thread waiting for events
+//========================================================================
+
+void _glfwPlatformPostEmptyEvent(void)
+{
+    const char byte = 0;
+
+    // A full pipe already guarantees a wake-up, so failure is harmless
+    (void) write(_glfwLibrary.X11.emptyEventPipe[1], &byte, 1);
+}
+
+
 //========================================================================
 // Set physical mouse cursor position
 //========================================================================
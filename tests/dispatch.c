@@ -0,0 +1,145 @@
+//========================================================================
+// Event dispatch benchmark
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test opens a number of windows and floods them with window size
+// events, then reports the time spent dispatching each event
+//
+// With window lookup being independent of the number of open windows, the
+// per-event cost reported should stay roughly flat as the count increases
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "getopt.h"
+
+static int event_count = 0;
+
+static void usage(void)
+{
+    printf("Usage: dispatch [-h] [-n WINDOWS] [-r ROUNDS]\n");
+}
+
+static void window_size_callback(GLFWwindow window, int width, int height)
+{
+    event_count++;
+}
+
+int main(int argc, char** argv)
+{
+    int i, ch, round, window_count = 40, round_count = 100, processed = 0;
+    double elapsed = 0.0;
+    GLFWwindow* windows;
+
+    while ((ch = getopt(argc, argv, "hn:r:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+            case 'n':
+                window_count = atoi(optarg);
+                break;
+            case 'r':
+                round_count = atoi(optarg);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (window_count < 1 || round_count < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    windows = (GLFWwindow*) calloc(window_count, sizeof(GLFWwindow));
+    if (!windows)
+    {
+        fprintf(stderr, "Failed to allocate window array\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0;  i < window_count;  i++)
+    {
+        windows[i] = glfwOpenWindow(100, 100, GLFW_WINDOWED, "Dispatch", NULL);
+        if (!windows[i])
+        {
+            fprintf(stderr, "Failed to open GLFW window: %s\n",
+                    glfwErrorString(glfwGetError()));
+            glfwTerminate();
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Let the initial burst of map and configure events settle
+    glfwPollEvents();
+
+    glfwSetWindowSizeCallback(window_size_callback);
+    event_count = 0;
+
+    for (round = 0;  round < round_count;  round++)
+    {
+        double start;
+        const int size = 100 + (round & 1) * 10;
+
+        for (i = 0;  i < window_count;  i++)
+            glfwSetWindowSize(windows[i], size, size);
+
+        start = glfwGetTime();
+        glfwPollEvents();
+        elapsed += glfwGetTime() - start;
+
+        processed += glfwGetCounter(GLFW_EVENTS_PROCESSED);
+    }
+
+    printf("%i windows, %i events processed (%i size changes) in %0.3f ms\n",
+           window_count, processed, event_count, elapsed * 1000.0);
+
+    if (processed)
+    {
+        printf("%0.3f us per event\n",
+               elapsed * 1000000.0 / (double) processed);
+    }
+
+    free(windows);
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
+
@@ -341,6 +341,14 @@ static void char_callback(GLFWwindow window, int character)
            get_character_string(character));
 }
 
+static void text_callback(GLFWwindow window, const char* text)
+{
+    printf("%08x at %0.3f: Text \"%s\" input\n",
+           counter++,
+           glfwGetTime(),
+           text);
+}
+
 int main(void)
 {
     GLFWwindow window;
@@ -366,6 +374,7 @@ int main(void)
     glfwSetScrollCallback(scroll_callback);
     glfwSetKeyCallback(key_callback);
     glfwSetCharCallback(char_callback);
+    glfwSetTextCallback(text_callback);
 
     window = glfwOpenWindow(0, 0, GLFW_WINDOWED, "Event Linter", NULL);
     if (!window)
@@ -0,0 +1,161 @@
+//========================================================================
+// GLXFBConfig cache invalidation test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test opens a single windowed mode window, so that GLFW enumerates
+// and caches the GLXFBConfigs, and then changes the screen size with RandR
+// and verifies that the cache is dropped when the screen change event
+// arrives
+//
+// Fullscreen windows are not needed to receive screen change events, so
+// none is opened here
+//
+// If RandR cannot change the screen size, change the screen configuration
+// by other means (with xrandr, for example) while the test waits
+//
+// As it looks at internal GLFW state, it is only built when GLFW is built
+// as a static library for X11
+//
+//========================================================================
+
+#include "internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Seconds to wait for the screen change event
+#define TIMEOUT 10.0
+
+#if defined(_GLFW_HAS_XRANDR)
+static SizeID original_size;
+static Rotation original_rotation;
+
+// Switch to a screen size other than the current one
+// Returns GL_FALSE if there is none
+static GLboolean change_screen_size(void)
+{
+    int size_count;
+    XRRScreenConfiguration* sc;
+
+    sc = XRRGetScreenInfo(_glfwLibrary.X11.display, _glfwLibrary.X11.root);
+    original_size = XRRConfigCurrentConfiguration(sc, &original_rotation);
+    XRRConfigSizes(sc, &size_count);
+
+    if (size_count < 2)
+    {
+        XRRFreeScreenConfigInfo(sc);
+        return GL_FALSE;
+    }
+
+    XRRSetScreenConfig(_glfwLibrary.X11.display,
+                       sc,
+                       _glfwLibrary.X11.root,
+                       (original_size + 1) % size_count,
+                       original_rotation,
+                       CurrentTime);
+
+    XRRFreeScreenConfigInfo(sc);
+    return GL_TRUE;
+}
+
+static void restore_screen_size(void)
+{
+    XRRScreenConfiguration* sc;
+
+    sc = XRRGetScreenInfo(_glfwLibrary.X11.display, _glfwLibrary.X11.root);
+
+    XRRSetScreenConfig(_glfwLibrary.X11.display,
+                       sc,
+                       _glfwLibrary.X11.root,
+                       original_size,
+                       original_rotation,
+                       CurrentTime);
+
+    XRRFreeScreenConfigInfo(sc);
+}
+#endif /*_GLFW_HAS_XRANDR*/
+
+int main(void)
+{
+    double start;
+    GLboolean changed = GL_FALSE, invalidated;
+    GLFWwindow window;
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        exit(EXIT_FAILURE);
+    }
+
+    window = glfwOpenWindow(200, 200, GLFW_WINDOWED, "FBConfig Cache", NULL);
+    if (!window)
+    {
+        fprintf(stderr, "Failed to open GLFW window: %s\n",
+                glfwErrorString(glfwGetError()));
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    if (!_glfwLibrary.GLX.fbconfigs)
+    {
+        fprintf(stderr, "The GLXFBConfigs were not cached\n");
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+#if defined(_GLFW_HAS_XRANDR)
+    if (_glfwLibrary.X11.RandR.available)
+        changed = change_screen_size();
+#endif /*_GLFW_HAS_XRANDR*/
+
+    if (!changed)
+    {
+        printf("Change the screen configuration within %0.0f seconds\n",
+               TIMEOUT);
+    }
+
+    start = glfwGetTime();
+
+    while (_glfwLibrary.GLX.fbconfigs && glfwGetTime() - start < TIMEOUT)
+        glfwWaitEventsTimeout(0.1);
+
+    invalidated = !_glfwLibrary.GLX.fbconfigs;
+
+#if defined(_GLFW_HAS_XRANDR)
+    if (changed)
+        restore_screen_size();
+#endif /*_GLFW_HAS_XRANDR*/
+
+    glfwTerminate();
+
+    if (!invalidated)
+    {
+        fprintf(stderr, "The GLXFBConfig cache was not dropped on screen change\n");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("The GLXFBConfig cache was dropped on screen change\n");
+    exit(EXIT_SUCCESS);
+}
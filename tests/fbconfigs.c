@@ -0,0 +1,329 @@
+//========================================================================
+// Framebuffer config selection benchmark
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test generates a set of synthetic framebuffer configs and times
+// selecting the closest match to a series of random requests with
+// _glfwChooseFBConfig, and ranking all of them with the column scoring of
+// _glfwRankFBConfigs, compared to a reference one config at a time scan
+//
+// It also verifies that all three pick the same config, and that every
+// ranking is complete and in order
+//
+// As it calls internal GLFW functions, it is only built when GLFW is built
+// as a static library, and needs no display to run
+//
+//========================================================================
+
+#include "internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+
+static void usage(void)
+{
+    printf("Usage: fbconfigs [CONFIGS [REQUESTS [SEED]]]\n");
+}
+
+// The original scoring of a single config
+// Returns GL_FALSE if the config violates a hard constraint
+static GLboolean score_reference(const _GLFWfbconfig* desired,
+                                 const _GLFWfbconfig* current,
+                                 unsigned int* scores)
+{
+    unsigned int missing, colorDiff, extraDiff;
+
+#define DIFF(member) \
+    ((desired->member - current->member) * (desired->member - current->member))
+
+    if (desired->stereo > 0 && current->stereo == 0)
+        return GL_FALSE;
+
+    missing = 0;
+    if (desired->alphaBits > 0 && current->alphaBits == 0)
+        missing++;
+    if (desired->depthBits > 0 && current->depthBits == 0)
+        missing++;
+    if (desired->stencilBits > 0 && current->stencilBits == 0)
+        missing++;
+    if (desired->auxBuffers > 0 && current->auxBuffers < desired->auxBuffers)
+        missing += desired->auxBuffers - current->auxBuffers;
+    if (desired->samples > 0 && current->samples == 0)
+        missing++;
+
+    colorDiff = 0;
+    if (desired->redBits > 0)
+        colorDiff += DIFF(redBits);
+    if (desired->greenBits > 0)
+        colorDiff += DIFF(greenBits);
+    if (desired->blueBits > 0)
+        colorDiff += DIFF(blueBits);
+
+    extraDiff = 0;
+    if (desired->alphaBits > 0)
+        extraDiff += DIFF(alphaBits);
+    if (desired->depthBits > 0)
+        extraDiff += DIFF(depthBits);
+    if (desired->stencilBits > 0)
+        extraDiff += DIFF(stencilBits);
+    if (desired->accumRedBits > 0)
+        extraDiff += DIFF(accumRedBits);
+    if (desired->accumGreenBits > 0)
+        extraDiff += DIFF(accumGreenBits);
+    if (desired->accumBlueBits > 0)
+        extraDiff += DIFF(accumBlueBits);
+    if (desired->accumAlphaBits > 0)
+        extraDiff += DIFF(accumAlphaBits);
+    if (desired->samples > 0)
+        extraDiff += DIFF(samples);
+
+#undef DIFF
+
+    scores[0] = missing;
+    scores[1] = colorDiff;
+    scores[2] = extraDiff;
+    return GL_TRUE;
+}
+
+// The original selection, scoring one config at a time
+static const _GLFWfbconfig* choose_reference(const _GLFWfbconfig* desired,
+                                             const _GLFWfbconfig* alternatives,
+                                             unsigned int count)
+{
+    unsigned int i;
+    unsigned int scores[3], least[3] = { UINT_MAX, UINT_MAX, UINT_MAX };
+    const _GLFWfbconfig* closest = NULL;
+
+    for (i = 0;  i < count;  i++)
+    {
+        if (!score_reference(desired, alternatives + i, scores))
+            continue;
+
+        if (scores[0] < least[0] ||
+            (scores[0] == least[0] &&
+             (scores[1] < least[1] ||
+              (scores[1] == least[1] && scores[2] < least[2]))))
+        {
+            closest = alternatives + i;
+            least[0] = scores[0];
+            least[1] = scores[1];
+            least[2] = scores[2];
+        }
+    }
+
+    return closest;
+}
+
+// Check that a ranking holds exactly the qualifying configs, best first,
+// with equally good configs in their original order
+static GLboolean check_ranking(const _GLFWfbconfig* desired,
+                               const _GLFWfbconfig* configs,
+                               unsigned int count,
+                               const unsigned int* ranking,
+                               unsigned int ranked)
+{
+    unsigned int i, j, qualifying = 0;
+    unsigned int scores[3], previous[3];
+
+    for (i = 0;  i < count;  i++)
+    {
+        if (score_reference(desired, configs + i, scores))
+            qualifying++;
+    }
+
+    if (ranked != qualifying)
+        return GL_FALSE;
+
+    for (i = 0;  i < ranked;  i++)
+    {
+        if (!score_reference(desired, configs + ranking[i], scores))
+            return GL_FALSE;
+
+        if (i > 0)
+        {
+            for (j = 0;  j < 3;  j++)
+            {
+                if (scores[j] != previous[j])
+                    break;
+            }
+
+            if (j == 3 ? ranking[i] < ranking[i - 1] : scores[j] < previous[j])
+                return GL_FALSE;
+        }
+
+        previous[0] = scores[0];
+        previous[1] = scores[1];
+        previous[2] = scores[2];
+    }
+
+    return GL_TRUE;
+}
+
+static int pick(const int* values, int count)
+{
+    return values[rand() % count];
+}
+
+static void generate_config(_GLFWfbconfig* config, GLboolean request)
+{
+    static const int colors[] = { 0, 5, 6, 8, 10 };
+    static const int depths[] = { 0, 16, 24, 32 };
+    static const int stencils[] = { 0, 8 };
+    static const int accums[] = { 0, 0, 0, 16 };
+    static const int samples[] = { 0, 0, 2, 4, 8 };
+
+    config->redBits = pick(colors + request, 4);
+    config->greenBits = pick(colors + request, 4);
+    config->blueBits = pick(colors + request, 4);
+    config->alphaBits = pick(colors, 5);
+    config->depthBits = pick(depths, 4);
+    config->stencilBits = pick(stencils, 2);
+    config->accumRedBits = pick(accums, 4);
+    config->accumGreenBits = config->accumRedBits;
+    config->accumBlueBits = config->accumRedBits;
+    config->accumAlphaBits = config->accumRedBits;
+    config->auxBuffers = rand() % 3;
+    config->stereo = request ? rand() % 8 == 0 : rand() % 4 == 0;
+    config->samples = pick(samples, 5);
+    config->platformID = 0;
+}
+
+int main(int argc, char** argv)
+{
+    int i, mismatches = 0, misranked = 0, requests = 1000;
+    unsigned int count = 1500, ranked;
+    unsigned int* ranking;
+    unsigned int seed = 1;
+    int* columns;
+    double reference, chosen, transposed, ranked_time;
+    _GLFWfbconfig* configs;
+    _GLFWfbconfig* desired;
+    const _GLFWfbconfig** expected;
+    clock_t start;
+
+    // The X11 headers pulled in by internal.h declare a getopt that clashes
+    // with the bundled one, so the arguments are positional
+    if (argc > 1)
+        count = (unsigned int) atoi(argv[1]);
+    if (argc > 2)
+        requests = atoi(argv[2]);
+    if (argc > 3)
+        seed = (unsigned int) atoi(argv[3]);
+
+    if (count < 1 || requests < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    configs = (_GLFWfbconfig*) calloc(count, sizeof(_GLFWfbconfig));
+    desired = (_GLFWfbconfig*) calloc(requests, sizeof(_GLFWfbconfig));
+    ranking = (unsigned int*) calloc(count, sizeof(unsigned int));
+    expected = (const _GLFWfbconfig**) calloc(requests, sizeof(_GLFWfbconfig*));
+    if (!configs || !desired || !ranking || !expected)
+    {
+        fprintf(stderr, "Failed to allocate configs\n");
+        exit(EXIT_FAILURE);
+    }
+
+    srand(seed);
+
+    for (i = 0;  i < (int) count;  i++)
+        generate_config(configs + i, GL_FALSE);
+
+    for (i = 0;  i < requests;  i++)
+        generate_config(desired + i, GL_TRUE);
+
+    // Each method is timed over all requests, as a single selection is
+    // too quick for the resolution of clock
+
+    start = clock();
+    for (i = 0;  i < requests;  i++)
+        expected[i] = choose_reference(desired + i, configs, count);
+    reference = (double) (clock() - start);
+
+    start = clock();
+    for (i = 0;  i < requests;  i++)
+    {
+        if (_glfwChooseFBConfig(desired + i, configs, count) != expected[i])
+            mismatches++;
+    }
+    chosen = (double) (clock() - start);
+
+    // The columns are built once and cached, as ranking is only needed when
+    // the closest config turns out to be unusable
+    start = clock();
+    columns = _glfwTransposeFBConfigs(configs, count);
+    transposed = (double) (clock() - start);
+
+    if (!columns)
+    {
+        fprintf(stderr, "Failed to allocate config columns\n");
+        exit(EXIT_FAILURE);
+    }
+
+    start = clock();
+    for (i = 0;  i < requests;  i++)
+    {
+        ranked = _glfwRankFBConfigs(desired + i, columns, count, ranking);
+        if (ranked ? configs + ranking[0] != expected[i] : expected[i] != NULL)
+            mismatches++;
+    }
+    ranked_time = (double) (clock() - start);
+
+    // The complete order is only verified after timing, as it is slow
+    for (i = 0;  i < requests;  i++)
+    {
+        ranked = _glfwRankFBConfigs(desired + i, columns, count, ranking);
+        if (!check_ranking(desired + i, configs, count, ranking, ranked))
+            misranked++;
+    }
+
+    printf("%i requests against %u configs\n", requests, count);
+    printf("One at a time scan:        %0.3f us per request\n",
+           reference * 1e6 / CLOCKS_PER_SEC / requests);
+    printf("Choosing:                  %0.3f us per request\n",
+           chosen * 1e6 / CLOCKS_PER_SEC / requests);
+    printf("Building columns:          %0.3f us once\n",
+           transposed * 1e6 / CLOCKS_PER_SEC);
+    printf("Ranking (cached columns):  %0.3f us per request\n",
+           ranked_time * 1e6 / CLOCKS_PER_SEC / requests);
+
+    free(columns);
+    free(configs);
+    free(desired);
+    free(ranking);
+    free(expected);
+
+    if (mismatches || misranked)
+    {
+        fprintf(stderr, "%i selections differed from the original scan, "
+                "%i rankings were out of order\n", mismatches, misranked);
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+}
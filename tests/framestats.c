@@ -0,0 +1,149 @@
+//========================================================================
+// Frame statistics test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test renders a number of frames and reports, for every completed
+// swap, the time from glfwSwapBuffers to presentation and any vertical
+// retraces that were missed
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "getopt.h"
+
+static void usage(void)
+{
+    printf("Usage: framestats [-h] [-i INTERVAL] [-n FRAMES]\n");
+}
+
+int main(int argc, char** argv)
+{
+    int i, ch, interval = 1, frame_count = 300, missed = 0;
+    double* swap_times;
+    GLFWframestats stats, last;
+    GLFWwindow window;
+
+    while ((ch = getopt(argc, argv, "hi:n:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+            case 'i':
+                interval = atoi(optarg);
+                break;
+            case 'n':
+                frame_count = atoi(optarg);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (frame_count < 1 || interval < 0)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    swap_times = (double*) calloc(frame_count, sizeof(double));
+    if (!swap_times)
+    {
+        fprintf(stderr, "Failed to allocate swap time array\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        exit(EXIT_FAILURE);
+    }
+
+    window = glfwOpenWindow(200, 200, GLFW_WINDOWED, "Frame Statistics", NULL);
+    if (!window)
+    {
+        fprintf(stderr, "Failed to open GLFW window: %s\n",
+                glfwErrorString(glfwGetError()));
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    glfwSwapInterval(interval);
+    glfwGetFrameStats(&last);
+
+    for (i = 0;  i < frame_count;  i++)
+    {
+        glClearColor((i & 1) ? 1.f : 0.f, 0.f, (i & 1) ? 0.f : 1.f, 0.f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        swap_times[i] = glfwGetTime();
+        glfwSwapBuffers();
+        glfwPollEvents();
+
+        glfwGetFrameStats(&stats);
+
+        if (stats.sbc == last.sbc || stats.sbc == 0 ||
+            stats.sbc > (unsigned int) frame_count)
+        {
+            continue;
+        }
+
+        printf("Swap %u presented after %0.3f ms",
+               stats.sbc, (stats.time - swap_times[stats.sbc - 1]) * 1000.0);
+
+        if (stats.exact)
+        {
+            const unsigned int expected = (stats.sbc - last.sbc) * interval;
+            const unsigned int elapsed = stats.msc - last.msc;
+
+            printf(" at MSC %u", stats.msc);
+
+            if (last.sbc && elapsed > expected)
+            {
+                printf(" (missed %u retraces)", elapsed - expected);
+                missed += elapsed - expected;
+            }
+        }
+
+        putchar('\n');
+        last = stats;
+    }
+
+    if (last.exact)
+        printf("Missed %i retraces in %i frames\n", missed, frame_count);
+    else
+        printf("Presentation times are not available, using swap times\n");
+
+    free(swap_times);
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
@@ -26,6 +26,7 @@
 // This test is a pale imitation of glxinfo(1), except not really
 //
 // It dumps GLFW and OpenGL version information
+// Any extension names given as arguments are checked for support
 //
 //========================================================================
 
@@ -51,7 +52,7 @@
 
 static void usage(void)
 {
-    printf("Usage: glfwinfo [-h] [-m MAJOR] [-n MINOR] [-d] [-l] [-f] [-p PROFILE] [-r STRATEGY]\n");
+    printf("Usage: glfwinfo [-h] [-m MAJOR] [-n MINOR] [-d] [-l] [-f] [-p PROFILE] [-r STRATEGY] [EXTENSION ...]\n");
     printf("available profiles: " PROFILE_NAME_CORE " " PROFILE_NAME_COMPAT " " PROFILE_NAME_ES2 "\n");
     printf("available strategies: " STRATEGY_NAME_NONE " " STRATEGY_NAME_LOSE "\n");
 }
@@ -119,6 +120,24 @@ static void list_extensions(int major, int minor)
     putchar('\n');
 }
 
+static void check_extensions(const char** extensions, int count)
+{
+    int i, supported;
+    unsigned int* mask = calloc((count + 31) / 32, sizeof(unsigned int));
+
+    supported = glfwExtensionsSupported(extensions, count, mask);
+
+    for (i = 0;  i < count;  i++)
+    {
+        printf("%s: %s\n", extensions[i],
+               (mask[i / 32] & (1u << (i % 32))) ? "supported" : "not supported");
+    }
+
+    printf("%i of %i extensions supported\n", supported, count);
+
+    free(mask);
+}
+
 int main(int argc, char** argv)
 {
     int ch, profile = 0, strategy = 0, major = 1, minor = 0, revision;
@@ -282,6 +301,9 @@ int main(int argc, char** argv)
     if (list)
         list_extensions(major, minor);
 
+    if (argc)
+        check_extensions((const char**) argv, argc);
+
     glfwTerminate();
     exit(EXIT_SUCCESS);
 }
@@ -0,0 +1,114 @@
+//========================================================================
+// Joystick event queue test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test prints every queued joystick event along with its timestamp
+// and how long ago it happened when it was retrieved
+//
+// With the evdev backend, the age is the latency from the device event to
+// the retrieval, which is what a frame would see
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "getopt.h"
+
+#define MAX_EVENTS 64
+
+static void usage(void)
+{
+    printf("Usage: joyevents [-h] [-s SECONDS]\n");
+}
+
+int main(int argc, char** argv)
+{
+    int ch, joy, i, count;
+    double start, now, duration = 20.0;
+    GLFWjoystickevent events[MAX_EVENTS];
+
+    while ((ch = getopt(argc, argv, "hs:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+            case 's':
+                duration = atof(optarg);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Printing joystick events for %0.1f seconds\n", duration);
+
+    start = glfwGetTime();
+
+    do
+    {
+        glfwWaitEventsTimeout(0.001);
+        now = glfwGetTime();
+
+        for (joy = GLFW_JOYSTICK_1;  joy <= GLFW_JOYSTICK_LAST;  joy++)
+        {
+            count = glfwGetJoystickEvents(joy, events, MAX_EVENTS);
+
+            for (i = 0;  i < count;  i++)
+            {
+                if (events[i].type == GLFW_AXIS_EVENT)
+                {
+                    printf("%0.6f: joystick %i axis %i value %i position %0.4f (age %0.3f ms)\n",
+                           events[i].time, joy, events[i].number,
+                           events[i].value, events[i].position,
+                           (now - events[i].time) * 1000.0);
+                }
+                else
+                {
+                    printf("%0.6f: joystick %i button %i %s (age %0.3f ms)\n",
+                           events[i].time, joy, events[i].number,
+                           events[i].value == GLFW_PRESS ? "pressed" : "released",
+                           (now - events[i].time) * 1000.0);
+                }
+            }
+        }
+    }
+    while (now - start < duration);
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
+
@@ -0,0 +1,120 @@
+//========================================================================
+// Joystick polling benchmark
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test simulates a number of frames, each polling for events and then
+// querying the axes and buttons of every connected joystick, and reports
+// the number of joystick system calls made per frame
+//
+// With joystick input being processed by the event loop, querying the
+// state of a joystick should not add any system calls to a frame
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "getopt.h"
+
+#define MAX_AXES     32
+#define MAX_BUTTONS  128
+
+static void usage(void)
+{
+    printf("Usage: joypoll [-h] [-f FRAMES]\n");
+}
+
+int main(int argc, char** argv)
+{
+    int ch, joy, frame, frame_count = 1000, joystick_count = 0;
+    int syscalls = 0;
+    double start, elapsed;
+    float axes[MAX_AXES];
+    unsigned char buttons[MAX_BUTTONS];
+
+    while ((ch = getopt(argc, argv, "hf:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+            case 'f':
+                frame_count = atoi(optarg);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (frame_count < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        exit(EXIT_FAILURE);
+    }
+
+    for (joy = GLFW_JOYSTICK_1;  joy <= GLFW_JOYSTICK_LAST;  joy++)
+    {
+        if (glfwGetJoystickParam(joy, GLFW_PRESENT))
+            joystick_count++;
+    }
+
+    start = glfwGetTime();
+
+    for (frame = 0;  frame < frame_count;  frame++)
+    {
+        glfwPollEvents();
+
+        for (joy = GLFW_JOYSTICK_1;  joy <= GLFW_JOYSTICK_LAST;  joy++)
+        {
+            if (!glfwGetJoystickParam(joy, GLFW_PRESENT))
+                continue;
+
+            glfwGetJoystickPos(joy, axes, MAX_AXES);
+            glfwGetJoystickButtons(joy, buttons, MAX_BUTTONS);
+        }
+
+        syscalls += glfwGetCounter(GLFW_JOYSTICK_SYSCALLS);
+    }
+
+    elapsed = glfwGetTime() - start;
+
+    printf("%i joysticks, %i frames, %i joystick syscalls in %0.3f ms\n",
+           joystick_count, frame_count, syscalls, elapsed * 1000.0);
+    printf("%0.2f syscalls per frame\n", (double) syscalls / frame_count);
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
+
@@ -35,6 +35,9 @@ static void updateJoysticksState(void)
 {
     int joy;
 
+    /* Joystick state is updated by event processing */
+    glfwPollEvents();
+
     for (joy = GLFW_JOYSTICK_1;  joy < GLFW_JOYSTICK_LAST + 1;  joy++)
     {
         printf("Updating information for joystick %d\n", joy);
@@ -87,6 +90,15 @@ static void displayJoysticksState(void)
     }
 }
 
+/*========================================================================
+ * Report joysticks being connected and disconnected
+ *========================================================================*/
+static void joystick_callback(int joy, int event)
+{
+    printf("Joystick %d was %s\n", joy,
+           event == GLFW_CONNECTED ? "connected" : "disconnected");
+}
+
 int main(void)
 {
     double start;
@@ -100,6 +112,8 @@ int main(void)
         exit(EXIT_FAILURE);
     }
 
+    glfwSetJoystickCallback(joystick_callback);
+
     printf("The program will work for 20 seconds and display every seconds the state of the joysticks\n");
     printf("Your computer is going to be very slow as the program is doing an active loop .....\n");
 
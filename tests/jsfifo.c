@@ -0,0 +1,256 @@
+//========================================================================
+// Joystick event read throughput test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test creates a fake joystick device, a FIFO of Linux js_event
+// records, and has GLFW open it with the internal _glfwOpenJoystickFile.
+// It then feeds a number of events per frame and retrieves them with
+// glfwGetJoystickEvents, verifying their order and reporting the
+// throughput and the number of joystick system calls per frame
+//
+// Finally it closes the FIFO and verifies that the joystick is reported
+// as disconnected
+//
+// As it calls an internal GLFW function, it is only built when GLFW is
+// built as a static library, and needs no joystick hardware or privileges
+// to run
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "getopt.h"
+
+#define JS_EVENT_AXIS 0x02
+#define MAX_EVENTS 256
+
+// Layout of the fake device
+#define FIFO_AXES 8
+#define FIFO_BUTTONS 16
+
+// The X11 headers pulled in by internal.h declare a getopt that clashes
+// with the bundled one, so the internal function is declared here
+int _glfwOpenJoystickFile(const char* path, int axes, int buttons);
+
+// Same layout as the Linux joystick driver event structure
+struct js_event {
+    unsigned int  time;
+    signed short  value;
+    unsigned char type;
+    unsigned char number;
+};
+
+static char dirname[] = "/tmp/jsfifoXXXXXX";
+static char path[sizeof(dirname) + 4];
+
+static void usage(void)
+{
+    printf("Usage: jsfifo [-h] [-n EVENTS] [-b EVENTS_PER_FRAME]\n");
+}
+
+static void remove_fifo(void)
+{
+    remove(path);
+    remove(dirname);
+}
+
+// Write the specified number of consecutive events in a single call
+static int feed_events(FILE* fifo, int first, int count)
+{
+    int i;
+    struct js_event* events;
+    size_t result;
+
+    events = (struct js_event*) calloc(count, sizeof(struct js_event));
+    if (!events)
+        return GL_FALSE;
+
+    for (i = 0;  i < count;  i++)
+    {
+        events[i].time = first + i;
+        events[i].value = (signed short) ((first + i) & 0x7fff);
+        events[i].type = JS_EVENT_AXIS;
+        events[i].number = (first + i) % FIFO_AXES;
+    }
+
+    result = fwrite(events, sizeof(struct js_event), count, fifo);
+    free(events);
+
+    return result == (size_t) count;
+}
+
+int main(int argc, char** argv)
+{
+    int i, ch, fd, joy, count;
+    FILE* fifo;
+    int event_count = 100000, batch = 64;
+    int sent = 0, received = 0, dropped = 0, corrupt = 0, frames = 0;
+    int syscalls = 0, expected = 0;
+    double start, elapsed;
+    GLFWjoystickevent events[MAX_EVENTS];
+
+    while ((ch = getopt(argc, argv, "hn:b:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+            case 'n':
+                event_count = atoi(optarg);
+                break;
+            case 'b':
+                batch = atoi(optarg);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (event_count < 1 || batch < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (!mkdtemp(dirname))
+    {
+        fprintf(stderr, "Failed to create temporary directory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    sprintf(path, "%s/js0", dirname);
+
+    if (mkfifo(path, 0600) != 0)
+    {
+        fprintf(stderr, "Failed to create fake device FIFO\n");
+        remove(dirname);
+        exit(EXIT_FAILURE);
+    }
+
+    // Open for both reading and writing so that the open does not block
+    // and GLFW does not see a hangup before it has opened its end
+    fd = open(path, O_RDWR | O_NONBLOCK);
+    fifo = fd != -1 ? fdopen(fd, "w") : NULL;
+    if (!fifo)
+    {
+        fprintf(stderr, "Failed to open fake device FIFO\n");
+        remove_fifo();
+        exit(EXIT_FAILURE);
+    }
+
+    // Each batch of events must reach the FIFO in a single write
+    setvbuf(fifo, NULL, _IONBF, 0);
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        remove_fifo();
+        exit(EXIT_FAILURE);
+    }
+
+    joy = _glfwOpenJoystickFile(path, FIFO_AXES, FIFO_BUTTONS);
+    if (joy == -1)
+    {
+        fprintf(stderr, "GLFW did not open the fake device\n");
+        glfwTerminate();
+        remove_fifo();
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Fake device opened as joystick %i with %i axes and %i buttons\n",
+           joy + 1,
+           glfwGetJoystickParam(joy, GLFW_AXES),
+           glfwGetJoystickParam(joy, GLFW_BUTTONS));
+
+    start = glfwGetTime();
+
+    while (sent < event_count)
+    {
+        const int size = event_count - sent < batch ? event_count - sent : batch;
+
+        if (!feed_events(fifo, sent, size))
+        {
+            fprintf(stderr, "Failed to feed events\n");
+            break;
+        }
+
+        sent += size;
+
+        glfwPollEvents();
+        syscalls += glfwGetCounter(GLFW_JOYSTICK_SYSCALLS);
+        frames++;
+
+        while ((count = glfwGetJoystickEvents(joy, events, MAX_EVENTS)))
+        {
+            for (i = 0;  i < count;  i++)
+            {
+                if (events[i].type != GLFW_AXIS_EVENT ||
+                    events[i].number != events[i].value % FIFO_AXES)
+                {
+                    corrupt++;
+                    continue;
+                }
+
+                // Events dropped by a full queue show up as a gap
+                dropped += (events[i].value - expected) & 0x7fff;
+                expected = events[i].value + 1;
+                received++;
+            }
+        }
+    }
+
+    elapsed = glfwGetTime() - start;
+
+    printf("%i events sent, %i received, %i dropped, %i corrupt\n",
+           sent, received, dropped, corrupt);
+    printf("%i frames in %0.3f ms (%0.2f Mevents/s), %0.2f system calls per frame\n",
+           frames, elapsed * 1000.0, received / elapsed / 1000000.0,
+           (double) syscalls / frames);
+
+    // Closing the last writer hangs up the FIFO, like unplugging a device
+    fclose(fifo);
+    glfwPollEvents();
+
+    if (glfwGetJoystickParam(joy, GLFW_PRESENT))
+    {
+        fprintf(stderr, "Joystick was not disconnected when the FIFO closed\n");
+        corrupt++;
+    }
+    else
+        printf("Joystick disconnected when the FIFO closed\n");
+
+    glfwTerminate();
+    remove_fifo();
+
+    exit(corrupt || received + dropped != sent ? EXIT_FAILURE : EXIT_SUCCESS);
+}
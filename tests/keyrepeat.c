@@ -0,0 +1,203 @@
+//========================================================================
+// Key repeat detection test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test counts the presses, repeats and releases of every key, and
+// flags any release that is followed by a press of the same key with the
+// same platform timestamp, as that is a key repeat that was reported as a
+// release
+//
+// It also flags any press that has the same platform timestamp as the
+// previous press of the same key, as that is a press that was reported both
+// when an input method filtered it and when the input method forwarded it
+// back to the window. To exercise that path, run the test with an input
+// method such as ibus or fcitx active and a locale that it supports
+//
+// The events are read from the input queue, so that they carry the time
+// they happened at rather than the time they were dispatched at, which is
+// nearly the same for every event in a synthetic flood
+//
+// Hold down keys, or flood the window with synthetic key events (with
+// xdotool, for example), then close the window to get the totals
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <locale.h>
+
+#include "getopt.h"
+
+#define MAX_EVENTS 256
+
+typedef struct
+{
+    int presses;
+    int repeats;
+    int releases;
+    int leaks;
+    int duplicates;
+    double released;
+    double pressed;
+} KeyStats;
+
+static KeyStats keys[GLFW_KEY_LAST + 1];
+static int down[GLFW_KEY_LAST + 1];
+static double threshold = 0.0;
+static int closed = GL_FALSE;
+
+static void usage(void)
+{
+    printf("Usage: keyrepeat [-h] [-t THRESHOLD]\n");
+    printf("The threshold is the number of milliseconds a press may follow a\n");
+    printf("release by and still be a leaked repeat, and defaults to zero\n");
+}
+
+static void process_key_event(const GLFWinputevent* event)
+{
+    KeyStats* stats = keys + event->code;
+
+    if (event->action == GLFW_PRESS)
+    {
+        // A press reported twice comes as two presses with the same
+        // timestamp, no matter how the second one is counted below
+        if ((stats->presses || stats->repeats) && event->time == stats->pressed)
+        {
+            printf("%0.3f Key %i pressed twice\n", event->time, event->code);
+            stats->duplicates++;
+        }
+
+        stats->pressed = event->time;
+
+        if (down[event->code])
+            stats->repeats++;
+        else
+        {
+            stats->presses++;
+
+            // A repeat reported as a release comes as a release and a press
+            // with the same timestamp, which no person can type
+            if (stats->releases && event->time - stats->released <= threshold)
+            {
+                printf("%0.3f Key %i pressed %0.3f ms after release\n",
+                       event->time, event->code,
+                       (event->time - stats->released) * 1000.0);
+                stats->leaks++;
+            }
+        }
+
+        down[event->code] = GL_TRUE;
+    }
+    else
+    {
+        stats->releases++;
+        stats->released = event->time;
+        down[event->code] = GL_FALSE;
+    }
+}
+
+static int window_close_callback(GLFWwindow window)
+{
+    closed = GL_TRUE;
+    return GL_TRUE;
+}
+
+int main(int argc, char** argv)
+{
+    int i, ch, count, leaks = 0, duplicates = 0;
+    GLFWwindow window;
+    GLFWinputevent events[MAX_EVENTS];
+
+    while ((ch = getopt(argc, argv, "ht:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+            case 't':
+                threshold = atof(optarg) / 1000.0;
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    // Use the user's locale so that any input method is used
+    setlocale(LC_ALL, "");
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        exit(EXIT_FAILURE);
+    }
+
+    window = glfwOpenWindow(200, 200, GLFW_WINDOWED, "Key Repeat", NULL);
+    if (!window)
+    {
+        fprintf(stderr, "Failed to open GLFW window: %s\n",
+                glfwErrorString(glfwGetError()));
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    glfwSetInputMode(window, GLFW_KEY_REPEAT, GL_TRUE);
+    glfwSetInputMode(window, GLFW_INPUT_QUEUE, GL_TRUE);
+    glfwSetWindowCloseCallback(window_close_callback);
+
+    while (!closed)
+    {
+        glfwWaitEvents();
+
+        while ((count = glfwGetInputEvents(window, events, MAX_EVENTS)))
+        {
+            for (i = 0;  i < count;  i++)
+            {
+                if (events[i].type == GLFW_KEY_EVENT)
+                    process_key_event(events + i);
+            }
+        }
+    }
+
+    for (i = 0;  i <= GLFW_KEY_LAST;  i++)
+    {
+        if (!keys[i].presses)
+            continue;
+
+        printf("Key %i: %i presses, %i repeats, %i releases, %i leaked repeats, "
+               "%i duplicate presses\n",
+               i, keys[i].presses, keys[i].repeats, keys[i].releases,
+               keys[i].leaks, keys[i].duplicates);
+
+        leaks += keys[i].leaks;
+        duplicates += keys[i].duplicates;
+    }
+
+    glfwTerminate();
+    exit(leaks || duplicates ? EXIT_FAILURE : EXIT_SUCCESS);
+}
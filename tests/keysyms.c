@@ -0,0 +1,200 @@
+//========================================================================
+// Keysym to Unicode translation benchmark
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test times translating random keysyms to Unicode with the page
+// table of _glfwKeySym2Unicode, compared to a binary search of the same
+// mappings stored as a sorted array of pairs, which is how GLFW used to
+// store them
+//
+// The sorted array is copied from the table the page table is built from,
+// so it also verifies that the page table translates every keysym the same
+// way as the original lookup did
+//
+// As it calls internal GLFW functions, it is only built when GLFW is built
+// as a static library for X11, and needs no display to run
+//
+//========================================================================
+
+#include "internal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct
+{
+    unsigned short keysym;
+    unsigned short ucs;
+} Codepair;
+
+static Codepair* pairs;
+static int paircount;
+
+static void usage(void)
+{
+    printf("Usage: keysyms [LOOKUPS [SEED]]\n");
+}
+
+static int is_latin1(KeySym keysym)
+{
+    return (keysym >= 0x0020 && keysym <= 0x007e) ||
+           (keysym >= 0x00a0 && keysym <= 0x00ff);
+}
+
+// The original translation, a binary search of the sorted pairs
+static long translate_reference(KeySym keysym)
+{
+    int min = 0;
+    int max = paircount - 1;
+    int mid;
+
+    if (is_latin1(keysym))
+        return keysym;
+
+    if ((keysym & 0xff000000) == 0x01000000)
+        return keysym & 0x00ffffff;
+
+    while (max >= min)
+    {
+        mid = (min + max) / 2;
+        if (pairs[mid].keysym < keysym)
+            min = mid + 1;
+        else if (pairs[mid].keysym > keysym)
+            max = mid - 1;
+        else
+            return pairs[mid].ucs;
+    }
+
+    return -1;
+}
+
+// Pick a keysym the way a typing user would, mostly mapped ones
+static KeySym generate_keysym(void)
+{
+    switch (rand() % 4)
+    {
+        case 0:
+            return 0x20 + rand() % 0xe0;
+        case 1:
+            return 0x01000000 | (rand() % 0x10000);
+        case 2:
+            return rand() % 0x10000;
+        default:
+            return pairs[rand() % paircount].keysym;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int i, lookups = 1000000, mismatches = 0, count;
+    unsigned int seed = 1;
+    long sum = 0;
+    KeySym keysym;
+    KeySym* keysyms;
+    const unsigned short* codepairs;
+    double table, search;
+    clock_t start;
+
+    // The X11 headers pulled in by internal.h declare a getopt that clashes
+    // with the bundled one, so the arguments are positional
+    if (argc > 1)
+        lookups = atoi(argv[1]);
+    if (argc > 2)
+        seed = (unsigned int) atoi(argv[2]);
+
+    if (lookups < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    if (!_glfwInitKeySym2Unicode())
+    {
+        fprintf(stderr, "Failed to build the keysym page table\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Copy the mappings in keysym order, as the original lookup searched them
+    codepairs = _glfwGetKeySymTable(&count);
+
+    pairs = (Codepair*) calloc(count, sizeof(Codepair));
+    keysyms = (KeySym*) calloc(lookups, sizeof(KeySym));
+    if (!pairs || !keysyms)
+    {
+        fprintf(stderr, "Failed to allocate keysyms\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0;  i < count;  i++)
+    {
+        pairs[paircount].keysym = codepairs[i * 2];
+        pairs[paircount].ucs = codepairs[i * 2 + 1];
+        paircount++;
+    }
+
+    for (keysym = 0;  keysym < 0x20000;  keysym++)
+    {
+        if (_glfwKeySym2Unicode(keysym) != translate_reference(keysym))
+            mismatches++;
+    }
+
+    srand(seed);
+
+    for (i = 0;  i < lookups;  i++)
+        keysyms[i] = generate_keysym();
+
+    // Both methods are timed over all lookups, as a single translation is
+    // too quick for the resolution of clock
+
+    start = clock();
+    for (i = 0;  i < lookups;  i++)
+        sum += translate_reference(keysyms[i]);
+    search = (double) (clock() - start);
+
+    start = clock();
+    for (i = 0;  i < lookups;  i++)
+        sum -= _glfwKeySym2Unicode(keysyms[i]);
+    table = (double) (clock() - start);
+
+    printf("%i lookups against %i mappings\n", lookups, paircount);
+    printf("Binary search:  %0.3f ns per lookup\n",
+           search * 1e9 / CLOCKS_PER_SEC / lookups);
+    printf("Page table:     %0.3f ns per lookup\n",
+           table * 1e9 / CLOCKS_PER_SEC / lookups);
+
+    _glfwTerminateKeySym2Unicode();
+    free(pairs);
+    free(keysyms);
+
+    // Both methods translated the same keysyms, so the sums must cancel out
+    if (mismatches || sum)
+    {
+        fprintf(stderr, "%i keysyms were translated differently\n",
+                mismatches);
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,139 @@
+//========================================================================
+// Offscreen context test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test opens a number of offscreen contexts, reports the time taken
+// to open each of them, and verifies that rendering to them works by
+// clearing each to a distinct color and reading back a pixel
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "getopt.h"
+
+static void usage(void)
+{
+    printf("Usage: offscreen [-h] [-n CONTEXTS] [-s SIZE]\n");
+}
+
+int main(int argc, char** argv)
+{
+    int i, ch, count = 10, size = 256, failed = 0;
+    double start, elapsed, total = 0.0;
+    GLFWwindow* contexts;
+
+    while ((ch = getopt(argc, argv, "hn:s:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+            case 'n':
+                count = atoi(optarg);
+                break;
+            case 's':
+                size = atoi(optarg);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (count < 1 || size < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    contexts = (GLFWwindow*) calloc(count, sizeof(GLFWwindow));
+    if (!contexts)
+    {
+        fprintf(stderr, "Failed to allocate context array\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0;  i < count;  i++)
+    {
+        GLubyte pixel[4];
+        const GLubyte expected = (GLubyte) (i * 255 / count);
+
+        start = glfwGetTime();
+        contexts[i] = glfwOpenWindow(size, size, GLFW_OFFSCREEN, NULL, NULL);
+        elapsed = glfwGetTime() - start;
+
+        if (!contexts[i])
+        {
+            fprintf(stderr, "Failed to open offscreen context: %s\n",
+                    glfwErrorString(glfwGetError()));
+            glfwTerminate();
+            exit(EXIT_FAILURE);
+        }
+
+        total += elapsed;
+
+        glClearColor(expected / 255.f, 0.f, 0.f, 1.f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glFinish();
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(size / 2, size / 2, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+
+        printf("Context %i opened in %0.3f ms, read back %u (expected %u)\n",
+               i, elapsed * 1000.0, pixel[0], expected);
+
+        if (abs((int) pixel[0] - (int) expected) > 1)
+            failed++;
+    }
+
+    printf("Mean time to open: %0.3f ms\n", total * 1000.0 / count);
+
+    for (i = 0;  i < count;  i++)
+        glfwCloseWindow(contexts[i]);
+
+    free(contexts);
+
+    glfwTerminate();
+
+    if (failed)
+    {
+        fprintf(stderr, "%i of %i contexts read back the wrong color\n",
+                failed, count);
+        exit(EXIT_FAILURE);
+    }
+
+    exit(EXIT_SUCCESS);
+}
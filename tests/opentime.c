@@ -0,0 +1,123 @@
+//========================================================================
+// Window opening latency test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test opens a number of windows and reports the time taken by each
+// call to glfwOpenWindow
+//
+// Framebuffer configurations are only enumerated by the first window, so
+// every later window should open noticeably faster than the first
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "getopt.h"
+
+static void usage(void)
+{
+    printf("Usage: opentime [-h] [-n WINDOWS]\n");
+}
+
+int main(int argc, char** argv)
+{
+    int i, ch, window_count = 30;
+    double start, elapsed, first = 0.0, rest = 0.0;
+    GLFWwindow* windows;
+
+    while ((ch = getopt(argc, argv, "hn:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+            case 'n':
+                window_count = atoi(optarg);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (window_count < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    windows = (GLFWwindow*) calloc(window_count, sizeof(GLFWwindow));
+    if (!windows)
+    {
+        fprintf(stderr, "Failed to allocate window array\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0;  i < window_count;  i++)
+    {
+        start = glfwGetTime();
+        windows[i] = glfwOpenWindow(100, 100, GLFW_WINDOWED, "Open Time", NULL);
+        elapsed = glfwGetTime() - start;
+
+        if (!windows[i])
+        {
+            fprintf(stderr, "Failed to open GLFW window: %s\n",
+                    glfwErrorString(glfwGetError()));
+            glfwTerminate();
+            exit(EXIT_FAILURE);
+        }
+
+        printf("Window %i opened in %0.3f ms\n", i, elapsed * 1000.0);
+
+        if (i == 0)
+            first = elapsed;
+        else
+            rest += elapsed;
+    }
+
+    printf("First window: %0.3f ms\n", first * 1000.0);
+
+    if (window_count > 1)
+    {
+        printf("Mean of remaining %i windows: %0.3f ms\n",
+               window_count - 1, rest * 1000.0 / (window_count - 1));
+    }
+
+    free(windows);
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
+
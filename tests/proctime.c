@@ -0,0 +1,180 @@
+//========================================================================
+// Entry point retrieval benchmark
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test reads the names of every function declared by a glext.h
+// header, such as the one in support/GL, and reports the time taken to
+// resolve all of them with a single call to glfwGetProcAddresses
+//
+// Entry points are cached by name, so every pass after the first should
+// be noticeably faster than the first
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "getopt.h"
+
+static void usage(void)
+{
+    printf("Usage: proctime [-h] [-n PASSES] HEADER\n");
+}
+
+static int read_names(const char* path, char*** names)
+{
+    int count = 0, capacity = 0;
+    char line[1024];
+    FILE* file;
+
+    file = fopen(path, "r");
+    if (!file)
+        return 0;
+
+    while (fgets(line, sizeof(line), file))
+    {
+        char* start;
+        char* end;
+
+        // Function declarations look like
+        // GLAPI void APIENTRY glName (arguments);
+        if (strncmp(line, "GLAPI ", 6) != 0)
+            continue;
+
+        start = strstr(line, "APIENTRY gl");
+        if (!start)
+            continue;
+
+        start += strlen("APIENTRY ");
+        end = start + strcspn(start, " (");
+
+        if (count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 256;
+            *names = (char**) realloc(*names, capacity * sizeof(char*));
+        }
+
+        (*names)[count] = (char*) malloc(end - start + 1);
+        memcpy((*names)[count], start, end - start);
+        (*names)[count][end - start] = '\0';
+        count++;
+    }
+
+    fclose(file);
+    return count;
+}
+
+int main(int argc, char** argv)
+{
+    int i, ch, count, found, pass_count = 10;
+    double start, elapsed, first = 0.0, rest = 0.0;
+    char** names = NULL;
+    void** procs;
+    GLFWwindow window;
+
+    while ((ch = getopt(argc, argv, "hn:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+            case 'n':
+                pass_count = atoi(optarg);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    argc -= optind;
+    argv += optind;
+
+    if (argc != 1 || pass_count < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    count = read_names(argv[0], &names);
+    if (!count)
+    {
+        fprintf(stderr, "Failed to read function names from %s\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    procs = (void**) calloc(count, sizeof(void*));
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        exit(EXIT_FAILURE);
+    }
+
+    window = glfwOpenWindow(100, 100, GLFW_WINDOWED, "Proc Time", NULL);
+    if (!window)
+    {
+        fprintf(stderr, "Failed to open GLFW window: %s\n",
+                glfwErrorString(glfwGetError()));
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0;  i < pass_count;  i++)
+    {
+        start = glfwGetTime();
+        found = glfwGetProcAddresses((const char**) names, procs, count);
+        elapsed = glfwGetTime() - start;
+
+        printf("Pass %i resolved %i of %i functions in %0.3f ms\n",
+               i, found, count, elapsed * 1000.0);
+
+        if (i == 0)
+            first = elapsed;
+        else
+            rest += elapsed;
+    }
+
+    printf("First pass: %0.3f ms\n", first * 1000.0);
+
+    if (pass_count > 1)
+    {
+        printf("Mean of remaining %i passes: %0.3f ms\n",
+               pass_count - 1, rest * 1000.0 / (pass_count - 1));
+    }
+
+    for (i = 0;  i < count;  i++)
+        free(names[i]);
+
+    free(names);
+    free(procs);
+
+    glfwTerminate();
+    exit(EXIT_SUCCESS);
+}
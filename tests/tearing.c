@@ -26,6 +26,8 @@
 // This test renders a high contrast, horizontally moving bar, allowing for
 // visual verification of whether the set swap interval is indeed obeyed
 //
+// Space toggles synchronization and A enables adaptive vsync, if available
+//
 //========================================================================
 
 #include <GL/glfw3.h>
@@ -39,12 +41,14 @@ static int swap_interval;
 static void set_swap_interval(int value)
 {
     char title[256];
+    GLFWwindow window = glfwGetCurrentContext();
 
     swap_interval = value;
     glfwSwapInterval(swap_interval);
 
-    sprintf(title, "Tearing detector (interval %i)", swap_interval);
-    glfwSetWindowTitle(glfwGetCurrentContext(), title);
+    sprintf(title, "Tearing detector (interval %i, in effect %i)",
+            swap_interval, glfwGetWindowParam(window, GLFW_SWAP_INTERVAL));
+    glfwSetWindowTitle(window, title);
 }
 
 static void window_size_callback(GLFWwindow window, int width, int height)
@@ -54,8 +58,20 @@ static void window_size_callback(GLFWwindow window, int width, int height)
 
 static void key_callback(GLFWwindow window, int key, int action)
 {
-    if (key == GLFW_KEY_SPACE && action == GLFW_PRESS)
-        set_swap_interval(!swap_interval);
+    if (action != GLFW_PRESS)
+        return;
+
+    switch (key)
+    {
+        case GLFW_KEY_SPACE:
+            set_swap_interval(!swap_interval);
+            break;
+        case GLFW_KEY_A:
+            // Adaptive vsync, i.e. only tear when a frame is late
+            if (glfwGetWindowParam(window, GLFW_SWAP_CONTROL) & GLFW_SWAP_TEAR_BIT)
+                set_swap_interval(-1);
+            break;
+    }
 }
 
 int main(void)
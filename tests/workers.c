@@ -0,0 +1,257 @@
+//========================================================================
+// Worker context upload test
+// Copyright (c) Camilla Berglund <elmindreda@elmindreda.org>
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would
+//    be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such, and must not
+//    be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source
+//    distribution.
+//
+//========================================================================
+//
+// This test creates a number of contexts sharing objects with a window and
+// hands each of them to a worker thread, which uploads textures while the
+// main thread keeps rendering to the window
+//
+// It reports the upload throughput of the workers and the frame rate of
+// the main thread while they were running
+//
+//========================================================================
+
+#include <GL/glfw3.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "getopt.h"
+
+typedef struct
+{
+    GLFWwindow context;
+    pthread_t thread;
+    int size;
+    int count;
+    double elapsed;
+    int result;
+} Worker;
+
+static volatile int running_workers;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void usage(void)
+{
+    printf("Usage: workers [-h] [-t THREADS] [-n TEXTURES] [-s SIZE]\n");
+}
+
+static void* upload_textures(void* arg)
+{
+    int i;
+    double start;
+    GLuint* textures;
+    GLubyte* pixels;
+    Worker* worker = (Worker*) arg;
+    const size_t bytes = (size_t) worker->size * worker->size * 4;
+
+    glfwMakeContextCurrent(worker->context);
+    if (glfwGetCurrentContext() != worker->context)
+    {
+        fprintf(stderr, "Failed to make worker context current: %s\n",
+                glfwErrorString(glfwGetError()));
+        worker->result = EXIT_FAILURE;
+        goto done;
+    }
+
+    textures = (GLuint*) calloc(worker->count, sizeof(GLuint));
+    pixels = (GLubyte*) malloc(bytes);
+    memset(pixels, 0x7f, bytes);
+
+    glGenTextures(worker->count, textures);
+
+    start = glfwGetTime();
+
+    for (i = 0;  i < worker->count;  i++)
+    {
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
+                     worker->size, worker->size, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+
+    // Make sure the uploads have completed before they are timed, as they
+    // would need to be before another context could use the textures
+    glFinish();
+
+    worker->elapsed = glfwGetTime() - start;
+    worker->result = glGetError() == GL_NO_ERROR ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    glDeleteTextures(worker->count, textures);
+    glfwMakeContextCurrent(NULL);
+
+    free(textures);
+    free(pixels);
+
+done:
+    pthread_mutex_lock(&lock);
+    running_workers--;
+    pthread_mutex_unlock(&lock);
+
+    return NULL;
+}
+
+int main(int argc, char** argv)
+{
+    int i, ch, frames = 0, result = EXIT_SUCCESS;
+    int thread_count = 2, texture_count = 64, size = 512;
+    double start, elapsed;
+    GLFWwindow window;
+    GLFWwindow* contexts;
+    Worker* workers;
+
+    while ((ch = getopt(argc, argv, "hn:s:t:")) != -1)
+    {
+        switch (ch)
+        {
+            case 'h':
+                usage();
+                exit(EXIT_SUCCESS);
+            case 'n':
+                texture_count = atoi(optarg);
+                break;
+            case 's':
+                size = atoi(optarg);
+                break;
+            case 't':
+                thread_count = atoi(optarg);
+                break;
+            default:
+                usage();
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (thread_count < 1 || texture_count < 1 || size < 1)
+    {
+        usage();
+        exit(EXIT_FAILURE);
+    }
+
+    contexts = (GLFWwindow*) calloc(thread_count, sizeof(GLFWwindow));
+    workers = (Worker*) calloc(thread_count, sizeof(Worker));
+
+    if (!glfwInit())
+    {
+        fprintf(stderr, "Failed to initialize GLFW: %s\n",
+                glfwErrorString(glfwGetError()));
+        exit(EXIT_FAILURE);
+    }
+
+    window = glfwOpenWindow(400, 400, GLFW_WINDOWED, "Workers", NULL);
+    if (!window)
+    {
+        fprintf(stderr, "Failed to open GLFW window: %s\n",
+                glfwErrorString(glfwGetError()));
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    start = glfwGetTime();
+
+    if (!glfwOpenSharedContexts(window, contexts, thread_count))
+    {
+        fprintf(stderr, "Failed to open shared contexts: %s\n",
+                glfwErrorString(glfwGetError()));
+        glfwTerminate();
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Opened %i shared contexts in %0.3f ms\n",
+           thread_count, (glfwGetTime() - start) * 1000.0);
+
+    glfwSwapInterval(0);
+
+    running_workers = thread_count;
+    start = glfwGetTime();
+
+    for (i = 0;  i < thread_count;  i++)
+    {
+        workers[i].context = contexts[i];
+        workers[i].size = size;
+        workers[i].count = texture_count;
+
+        if (pthread_create(&workers[i].thread, NULL, upload_textures, workers + i) != 0)
+        {
+            fprintf(stderr, "Failed to create worker thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Keep rendering on the main thread while the workers upload
+    for (;;)
+    {
+        int running;
+
+        pthread_mutex_lock(&lock);
+        running = running_workers;
+        pthread_mutex_unlock(&lock);
+
+        if (!running)
+            break;
+
+        glClearColor((frames & 1) ? 1.f : 0.f, 0.f, 0.f, 0.f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glfwSwapBuffers();
+        glfwPollEvents();
+
+        frames++;
+    }
+
+    elapsed = glfwGetTime() - start;
+
+    for (i = 0;  i < thread_count;  i++)
+    {
+        const double megabytes =
+            (double) size * size * 4 * texture_count / (1024.0 * 1024.0);
+
+        pthread_join(workers[i].thread, NULL);
+
+        if (workers[i].result != EXIT_SUCCESS)
+        {
+            printf("Worker %i failed\n", i);
+            result = EXIT_FAILURE;
+            continue;
+        }
+
+        printf("Worker %i uploaded %0.1f MB in %0.3f ms (%0.1f MB/s)\n",
+               i, megabytes, workers[i].elapsed * 1000.0,
+               megabytes / workers[i].elapsed);
+    }
+
+    printf("Main thread rendered %i frames in %0.3f ms (%0.1f FPS)\n",
+           frames, elapsed * 1000.0, frames / elapsed);
+
+    for (i = 0;  i < thread_count;  i++)
+        glfwCloseWindow(contexts[i]);
+
+    free(contexts);
+    free(workers);
+
+    glfwTerminate();
+    exit(result);
+}